@@ -4,6 +4,7 @@ release_no_lp = ["-DCMAKE_BUILD_TYPE=Release", "-DUSE_LP=NO"]
 # USE_GLIBCXX_DEBUG is not compatible with USE_LP (see issue983).
 glibcxx_debug = ["-DCMAKE_BUILD_TYPE=Debug", "-DUSE_LP=NO", "-DUSE_GLIBCXX_DEBUG=YES"]
 minimal = ["-DCMAKE_BUILD_TYPE=Release", "-DDISABLE_LIBRARIES_BY_DEFAULT=YES"]
+benchmark = ["-DCMAKE_BUILD_TYPE=Release", "-DBUILD_SYMBOLIC_BENCHMARK=YES"]
 
 DEFAULT = "release"
 DEBUG = "debug"
@@ -0,0 +1,44 @@
+import os
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+SAS_FILE = os.path.join(REPO, "test-symbolic.sas")
+PLAN_STREAM_FILE = os.path.join(REPO, "test-symbolic.plans")
+TASK = os.path.join(BENCHMARKS_DIR, "gripper/prob01.pddl")
+NUM_PLANS = 5
+
+
+def translate(task):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", SAS_FILE, "--translate", task], cwd=REPO)
+
+
+def setup_module(module):
+    translate(TASK)
+
+
+# The search fails if no plan is reported, so this also checks that the
+# selector counts the streamed plans.
+@pytest.mark.parametrize("selector", ["top_k", "unordered"])
+def test_plan_stream(selector):
+    plan_selection = '{}(num_plans={},plan_stream_file="{}")'.format(
+        selector, NUM_PLANS, PLAN_STREAM_FILE)
+    search = "symk_fw(plan_selection={})".format(plan_selection)
+    subprocess.check_call(
+        [sys.executable, FAST_DOWNWARD, SAS_FILE, "--search", search],
+        cwd=REPO)
+    with open(PLAN_STREAM_FILE) as f:
+        num_plans = sum(1 for line in f if line.startswith("; plan "))
+    assert num_plans == NUM_PLANS
+
+
+def teardown_module(module):
+    os.remove(SAS_FILE)
+    if os.path.exists(PLAN_STREAM_FILE):
+        os.remove(PLAN_STREAM_FILE)
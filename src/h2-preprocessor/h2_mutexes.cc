@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <iterator>
 #include <set>
+#include <thread>
 #include <vector>
 
 using namespace std;
@@ -44,8 +45,8 @@ bool compute_h2_mutexes(
     const vector<Variable *> &variables, vector<Operator> &operators,
     vector<Axiom> &axioms, vector<MutexGroup> &mutexes, State &initial_state,
     const vector<pair<Variable *, int>> &goals, int limit_seconds,
-    bool disable_bw_h2) {
-    H2Mutexes h2(limit_seconds);
+    bool disable_bw_h2, int num_threads) {
+    H2Mutexes h2(limit_seconds, num_threads);
 
     if (!h2.initialize(variables, mutexes)) {
         return true;
@@ -510,74 +511,15 @@ int H2Mutexes::compute(
 
     cout << "Computing mutexes..." << endl;
 
-    bool updated;
+    init_bitsets();
+    int updated;
     do {
-        // if (time_exceeded())
-        //     return TIMEOUT;
-
-        updated = false;
-        for (unsigned op_i = 0; op_i < m_ops.size(); op_i++) {
-            if (op_i % 10000 == 0 && time_exceeded())
-                return TIMEOUT;
-
-            // disregard spurious operators
-            if (m_ops[op_i].triggered == SPURIOUS)
-                continue;
-
-            // if the preconditions haven't been met, continue
-            if ((m_ops[op_i].triggered != REACHED) &&
-                ((m_ops[op_i].triggered = eval_propositions(m_ops[op_i].pre)) !=
-                 REACHED))
-                continue;
-
-            for (unsigned add_i = 0; add_i < m_ops[op_i].add.size(); add_i++) {
-                unsigned p = m_ops[op_i].add[add_i];
-                for (unsigned add_j = 0; add_j < m_ops[op_i].add.size();
-                     add_j++) {
-                    unsigned q = m_ops[op_i].add[add_j];
-                    if (m_values[position(p, q)] == NOT_REACHED) {
-                        m_values[position(p, q)] = m_values[position(q, p)] =
-                            REACHED;
-                        updated = true;
-                    }
-                }
-
-                for (unsigned prop_i = 0; prop_i < number_props; prop_i++) {
-                    if (m_values[position(prop_i, prop_i)] != REACHED ||
-                        m_values[position(p, prop_i)] != NOT_REACHED)
-                        continue;
-
-                    if (binary_search(
-                            m_ops[op_i].add.begin(), m_ops[op_i].add.end(),
-                            prop_i) ||
-                        binary_search(
-                            m_ops[op_i].del.begin(), m_ops[op_i].del.end(),
-                            prop_i)) {
-                        continue;
-                    }
-
-                    bool satisfied = true;
-                    for (unsigned pre_i = 0;
-                         satisfied && pre_i < m_ops[op_i].pre.size(); pre_i++) {
-                        satisfied =
-                            (m_values[position(
-                                 prop_i, m_ops[op_i].pre[pre_i])] == REACHED);
-                    }
-
-                    if (satisfied) {
-                        // pair<unsigned, unsigned> a = p_index_reverse[prop_i];
-                        // pair<unsigned, unsigned> b = p_index_reverse[p];
-                        // cout << "Action: " << g_operators[op_i].get_name() <<
-                        // " -> "; cout << print_fluent(a.first,a.second) << " -
-                        // " << print_fluent(b.first,b.second) << endl;
-                        m_values[position(p, prop_i)] =
-                            m_values[position(prop_i, p)] = REACHED;
-                        updated = true;
-                    }
-                }
-            }
-        }
+        updated = num_threads > 1 ? sweep_parallel() : sweep_sequential();
+        if (updated == TIMEOUT)
+            return TIMEOUT;
     } while (updated);
+    vector<vector<Word>>().swap(reached_bits);
+    vector<vector<Word>>().swap(not_reached_bits);
 
     int countReached = 0, countNotReached = 0, countSpurious = 0;
     for (unsigned i = 0; i < m_values.size(); i++) {
@@ -672,6 +614,147 @@ int H2Mutexes::compute(
     return count + countUnreachable;
 }
 
+void H2Mutexes::init_bitsets() {
+    num_words = (number_props + 63) / 64;
+    reached_bits.assign(number_props, vector<Word>(num_words, 0));
+    not_reached_bits.assign(number_props, vector<Word>(num_words, 0));
+    props_reached.assign(num_words, 0);
+    for (unsigned p = 0; p < number_props; ++p) {
+        for (unsigned q = 0; q < number_props; ++q) {
+            Word bit = Word(1) << (q % 64);
+            if (m_values[position(p, q)] == REACHED) {
+                reached_bits[p][q / 64] |= bit;
+            } else if (m_values[position(p, q)] == NOT_REACHED) {
+                not_reached_bits[p][q / 64] |= bit;
+            }
+        }
+        if (m_values[position(p, p)] == REACHED) {
+            props_reached[p / 64] |= Word(1) << (p % 64);
+        }
+    }
+}
+
+void H2Mutexes::set_reached(unsigned p, unsigned q) {
+    reached_bits[p][q / 64] |= Word(1) << (q % 64);
+    reached_bits[q][p / 64] |= Word(1) << (p % 64);
+    not_reached_bits[p][q / 64] &= ~(Word(1) << (q % 64));
+    not_reached_bits[q][p / 64] &= ~(Word(1) << (p % 64));
+    m_values[position(p, q)] = m_values[position(q, p)] = REACHED;
+    if (p == q) {
+        props_reached[p / 64] |= Word(1) << (p % 64);
+    }
+}
+
+bool H2Mutexes::eval_propositions_bits(const vector<unsigned> &props) const {
+    for (unsigned i = 0; i < props.size(); i++)
+        for (unsigned j = i; j < props.size(); j++)
+            if ((not_reached_bits[props[i]][props[j] / 64] >>
+                 (props[j] % 64)) &
+                1)
+                return false;
+    return true;
+}
+
+/*
+  Collects the pairs that become reached by applying op in the current table.
+  A proposition q can be reached together with an add p if q is reached, it
+  is neither added nor deleted by op, and it is reached together with all
+  preconditions. This is computed for all q at once as the word-wise AND of
+  the rows of the preconditions.
+*/
+void H2Mutexes::compute_op_updates(
+    Op_h2 &op, vector<Word> &compatible, vector<PairUpdate> &updates) const {
+    if (op.triggered == SPURIOUS)
+        return;
+    if (op.triggered != REACHED) {
+        if (!eval_propositions_bits(op.pre))
+            return;
+        op.triggered = REACHED;
+    }
+
+    compatible = props_reached;
+    for (unsigned pre : op.pre) {
+        const vector<Word> &row = reached_bits[pre];
+        for (unsigned w = 0; w < num_words; ++w)
+            compatible[w] &= row[w];
+    }
+    for (unsigned q : op.add)
+        compatible[q / 64] &= ~(Word(1) << (q % 64));
+    for (unsigned q : op.del)
+        compatible[q / 64] &= ~(Word(1) << (q % 64));
+
+    for (unsigned p : op.add) {
+        const vector<Word> &row = not_reached_bits[p];
+        for (unsigned q : op.add) {
+            if ((row[q / 64] >> (q % 64)) & 1)
+                updates.push_back({p, q / 64, Word(1) << (q % 64)});
+        }
+        for (unsigned w = 0; w < num_words; ++w) {
+            Word new_bits = compatible[w] & row[w];
+            if (new_bits)
+                updates.push_back({p, w, new_bits});
+        }
+    }
+}
+
+bool H2Mutexes::apply_updates(const vector<PairUpdate> &updates) {
+    bool updated = false;
+    for (const PairUpdate &update : updates) {
+        // Other updates may have reached some of the pairs already
+        Word new_bits = update.bits & not_reached_bits[update.prop][update.word];
+        for (unsigned q = update.word * 64; new_bits; ++q, new_bits >>= 1) {
+            if (new_bits & 1) {
+                set_reached(update.prop, q);
+                updated = true;
+            }
+        }
+    }
+    return updated;
+}
+
+// Applies the operators one by one, so that each sees the previous updates.
+int H2Mutexes::sweep_sequential() {
+    bool updated = false;
+    vector<Word> compatible;
+    vector<PairUpdate> updates;
+    for (unsigned op_i = 0; op_i < m_ops.size(); op_i++) {
+        if (op_i % 10000 == 0 && time_exceeded())
+            return TIMEOUT;
+        updates.clear();
+        compute_op_updates(m_ops[op_i], compatible, updates);
+        updated |= apply_updates(updates);
+    }
+    return updated;
+}
+
+// Each thread computes the updates of a slice of the operators wrt. the table
+// at the start of the sweep. The updates are applied after all threads are
+// done, so more sweeps may be needed than in the sequential version.
+int H2Mutexes::sweep_parallel() {
+    vector<vector<PairUpdate>> thread_updates(num_threads);
+    vector<thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([this, t, &thread_updates]() {
+            vector<Word> compatible;
+            for (size_t op_i = t; op_i < m_ops.size(); op_i += num_threads) {
+                if (op_i % 10000 < static_cast<size_t>(num_threads) &&
+                    time_limit_reached())
+                    return;
+                compute_op_updates(m_ops[op_i], compatible, thread_updates[t]);
+            }
+        });
+    }
+    for (thread &t : threads)
+        t.join();
+    if (time_exceeded())
+        return TIMEOUT;
+
+    bool updated = false;
+    for (const vector<PairUpdate> &updates : thread_updates)
+        updated |= apply_updates(updates);
+    return updated;
+}
+
 Reachability H2Mutexes::eval_propositions(const vector<unsigned> &props) {
     if (props.empty())
         return REACHED;
@@ -706,11 +789,14 @@ void H2Mutexes::print_pair(unsigned /*pair*/) {
     // related to " << g_fact_names[b.first][0] << endl;
 }
 
-bool H2Mutexes::time_exceeded() {
+bool H2Mutexes::time_limit_reached() const {
     if (limit_seconds == -1) // no limit
         return false;
+    return difftime(time(NULL), start) > limit_seconds;
+}
 
-    if (difftime(time(NULL), start) > limit_seconds) {
+bool H2Mutexes::time_exceeded() {
+    if (time_limit_reached()) {
         cout << "h^mutexes could not be computed (building time)" << endl;
         return true;
     }
@@ -10,6 +10,7 @@
 #include "variable.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <ctime>
 #include <iostream>
 #include <string>
@@ -71,7 +72,8 @@ class H2Mutexes {
     bool check_goal_state_is_unreachable(
         const vector<pair<Variable *, int>> &goal) const;
 public:
-    H2Mutexes(int t = -1) : limit_seconds(t) {
+    H2Mutexes(int t = -1, int threads = 1)
+        : limit_seconds(t), num_threads(threads) {
         if (limit_seconds != -1)
             time(&start);
     }
@@ -133,6 +135,29 @@ protected:
     vector<unsigned> m_values;
     vector<Op_h2> m_ops;
 
+    // Packed copy of m_values used during the fixpoint computation:
+    // bit q of row p is set iff the pair (p, q) is REACHED (or NOT_REACHED,
+    // respectively). props_reached holds the REACHED pairs (p, p).
+    typedef uint64_t Word;
+    struct PairUpdate {
+        unsigned prop;
+        unsigned word;
+        Word bits;
+    };
+    unsigned num_words;
+    vector<vector<Word>> reached_bits, not_reached_bits;
+    vector<Word> props_reached;
+
+    void init_bitsets();
+    void set_reached(unsigned p, unsigned q);
+    bool eval_propositions_bits(const vector<unsigned> &props) const;
+    void compute_op_updates(
+        Op_h2 &op, vector<Word> &compatible,
+        vector<PairUpdate> &updates) const;
+    bool apply_updates(const vector<PairUpdate> &updates);
+    int sweep_sequential();
+    int sweep_parallel();
+
     vector<vector<unsigned>> p_index;
     vector<pair<unsigned, unsigned>> p_index_reverse;
 
@@ -150,6 +175,8 @@ protected:
 
     int limit_seconds;
     time_t start;
+    int num_threads;
+    bool time_limit_reached() const;
     bool time_exceeded();
 
     bool init_values_progression(
@@ -168,6 +195,6 @@ extern bool compute_h2_mutexes(
     const vector<Variable *> &variables, vector<Operator> &operators,
     vector<Axiom> &axioms, vector<MutexGroup> &mutexes, State &initial_state,
     const vector<pair<Variable *, int>> &goal, int limit_seconds,
-    bool disable_bw_h2);
+    bool disable_bw_h2, int num_threads = 1);
 
 #endif
@@ -18,6 +18,7 @@ using namespace std;
 
 int main(int argc, const char **argv) {
     int h2_mutex_time = 300; // 5 minutes to compute mutexes by default
+    int h2_threads = 1;
     bool include_augmented_preconditions = false;
     bool expensive_statistics = false;
     bool disable_bw_h2 = false;
@@ -54,6 +55,16 @@ int main(int argc, const char **argv) {
                     << endl;
                 exit(2);
             }
+        } else if (arg.compare("--h2_threads") == 0) {
+            i++;
+            if (i < argc && atoi(argv[i]) > 0) {
+                h2_threads = atoi(argv[i]);
+            } else {
+                cerr << "please specify a positive number of threads after "
+                        "--h2_threads"
+                     << endl;
+                exit(2);
+            }
         } else if (arg.compare("--sas-file") == 0) {
             i++;
             if (i < argc) {
@@ -79,7 +90,7 @@ int main(int argc, const char **argv) {
         } else {
             cerr << "unknown option " << arg << endl << endl;
             cout
-                << "Usage: ./preprocess [--keep-unimportant-variables] [--sas-file] [--h2_time_limit TIME_IN_SEC] [--no_h2]  [--no_bw_h2] [--augmented_pre] [--stat] < output"
+                << "Usage: ./preprocess [--keep-unimportant-variables] [--sas-file] [--h2_time_limit TIME_IN_SEC] [--h2_threads NUM] [--no_h2]  [--no_bw_h2] [--augmented_pre] [--stat] < output"
                 << endl;
             exit(2);
         }
@@ -122,7 +133,7 @@ int main(int argc, const char **argv) {
 
         if (!compute_h2_mutexes(
                 ordering, operators, axioms, mutexes, initial_state, goals,
-                h2_mutex_time, disable_bw_h2)) {
+                h2_mutex_time, disable_bw_h2, h2_threads)) {
             // TODO: don't duplicate the code to return an unsolvable task, log
             // and exit here
             cout << "Unsolvable task in preprocessor" << endl;
@@ -0,0 +1,234 @@
+/*
+ * Benchmark of the hot paths of the symbolic search. It reads a SAS task from
+ * stdin and writes one JSON line per measurement to the output file:
+ *
+ *   symbolic_benchmark --search "sym_benchmark(layers=10)" < output.sas
+ *
+ * The measurements are the construction of the transition relations for
+ * each ce_transition_type, the first layers of a breadth-first fw and bw
+ * exploration (image, mutex filtering and merging of the image BDDs) and,
+ * optionally, the plan reconstruction of a complete symbolic search.
+ */
+
+#include "../search_algorithms/symbolic_search.h"
+#include "../sym_enums.h"
+#include "../sym_parameters.h"
+#include "../sym_state_space_manager.h"
+#include "../sym_trace.h"
+#include "../sym_variables.h"
+
+#include "../../command_line.h"
+#include "../../search_algorithm.h"
+
+#include "../../plugins/plugin.h"
+#include "../../task_utils/task_properties.h"
+#include "../../tasks/root_task.h"
+#include "../../utils/logging.h"
+#include "../../utils/system.h"
+#include "../../utils/timer.h"
+
+#include <sstream>
+
+using namespace std;
+
+namespace symbolic {
+class SymbolicBenchmark : public SearchAlgorithm {
+    shared_ptr<AbstractTask> task;
+    shared_ptr<SymVariables> vars;
+    SymParameters sym_params;
+    vector<ConditionalEffectsTransitionType> ce_transition_types;
+    int layers;
+    shared_ptr<SearchAlgorithm> reconstruction_search;
+    SymTrace results;
+
+    void benchmark_transition_relations();
+    void benchmark_layers(SymStateSpaceManager &mgr, bool fw);
+    void benchmark_reconstruction();
+
+protected:
+    virtual SearchStatus step() override;
+
+public:
+    explicit SymbolicBenchmark(const plugins::Options &opts);
+
+    virtual void print_statistics() const override {
+    }
+};
+
+SymbolicBenchmark::SymbolicBenchmark(const plugins::Options &opts)
+    : SearchAlgorithm(opts),
+      task(tasks::g_root_task),
+      vars(make_shared<SymVariables>(opts, task)),
+      sym_params(opts, task),
+      ce_transition_types(opts.get_list<ConditionalEffectsTransitionType>(
+          "ce_transition_types")),
+      layers(opts.get<int>("layers")),
+      results(opts.get<string>("output")) {
+    if (opts.contains("reconstruction_search")) {
+        reconstruction_search =
+            opts.get<shared_ptr<SearchAlgorithm>>("reconstruction_search");
+    }
+    vars->init();
+}
+
+void SymbolicBenchmark::benchmark_transition_relations() {
+    for (ConditionalEffectsTransitionType ce_type : ce_transition_types) {
+        SymParameters params(sym_params);
+        params.ce_transition_type = ce_type;
+        utils::Timer timer;
+        SymStateSpaceManager mgr(vars.get(), params, task);
+        double time = timer();
+
+        long num_trs = 0;
+        long tr_nodes = 0;
+        shared_ptr<SymTransitionRelations> sym_trs =
+            mgr.get_transition_relations();
+        for (const auto &trs : sym_trs->get_transition_relations()) {
+            for (const TransitionRelationPtr &tr : trs.second) {
+                ++num_trs;
+                tr_nodes += tr->nodeCount();
+            }
+        }
+        ostringstream ce_name;
+        ce_name << ce_type;
+        results.set("benchmark", string("transition_relations"));
+        results.set("ce_transition_type", ce_name.str());
+        results.set("num_trs", num_trs);
+        results.set("tr_nodes", tr_nodes);
+        results.add_time("construction", time);
+        results.write_layer();
+    }
+}
+
+// Breadth-first exploration that ignores the operator costs, so that each
+// layer contains the images of all transition relations.
+void SymbolicBenchmark::benchmark_layers(SymStateSpaceManager &mgr, bool fw) {
+    BDD reached = fw ? mgr.get_initial_state() : mgr.get_goal();
+    reached = mgr.filter_mutex(reached, fw, 0, true);
+    BDD frontier = reached;
+    for (int layer = 0; layer < layers && !frontier.IsZero(); ++layer) {
+        results.set("benchmark", string("layer"));
+        results.set("dir", string(fw ? "FW" : "BW"));
+        results.set("layer", static_cast<long>(layer));
+        results.set("frontier_nodes", static_cast<long>(frontier.nodeCount()));
+
+        utils::Timer timer;
+        Bucket images;
+        if (mgr.has_zero_cost_transition()) {
+            ImageProgress progress;
+            mgr.zero_image(fw, frontier, images, 0, progress);
+        }
+        map<int, Bucket> cost_images;
+        ImageProgress progress;
+        mgr.cost_image(fw, frontier, cost_images, 0, progress);
+        for (const auto &bucket : cost_images) {
+            images.insert(
+                images.end(), bucket.second.begin(), bucket.second.end());
+        }
+        results.add_time("image", timer.reset());
+        results.set("image_bdds", static_cast<long>(images.size()));
+        results.set("image_nodes", static_cast<long>(nodeCount(images)));
+
+        mgr.filter_mutex(images, fw, false);
+        results.add_time("mutex_filter", timer.reset());
+
+        mgr.merge_bucket(images);
+        BDD image = mgr.zeroBDD();
+        for (const BDD &bdd : images) {
+            image += bdd;
+        }
+        results.add_time("merge", timer.reset());
+
+        frontier = image * !reached;
+        reached += frontier;
+        results.write_layer();
+    }
+}
+
+void SymbolicBenchmark::benchmark_reconstruction() {
+    utils::Timer timer;
+    reconstruction_search->search();
+    double time = timer();
+
+    results.set("benchmark", string("reconstruction"));
+    auto sym_search =
+        dynamic_pointer_cast<SymbolicSearch>(reconstruction_search);
+    if (sym_search) {
+        const auto &registry = sym_search->get_solution_registry();
+        results.set(
+            "plans", static_cast<long>(registry->get_num_found_plans()));
+        results.add_time("reconstruction", registry->get_reconstruction_time());
+    }
+    results.add_time("search", time);
+    results.write_layer();
+}
+
+SearchStatus SymbolicBenchmark::step() {
+    benchmark_transition_relations();
+
+    SymStateSpaceManager mgr(vars.get(), sym_params, task);
+    benchmark_layers(mgr, true);
+    benchmark_layers(mgr, false);
+
+    if (reconstruction_search) {
+        benchmark_reconstruction();
+    }
+    return FAILED;
+}
+
+class SymbolicBenchmarkFeature
+    : public plugins::TypedFeature<SearchAlgorithm, SymbolicBenchmark> {
+public:
+    SymbolicBenchmarkFeature() : TypedFeature("sym_benchmark") {
+        document_title("Symbolic benchmark");
+        document_synopsis(
+            "Measures the construction of the transition relations, the "
+            "images, mutex filtering and merging of the first layers, and "
+            "the plan reconstruction of a symbolic search.");
+        add_search_algorithm_options_to_feature(*this, "sym_benchmark");
+        SymVariables::add_options_to_feature(*this);
+        SymParameters::add_options_to_feature(*this);
+        add_list_option<ConditionalEffectsTransitionType>(
+            "ce_transition_types",
+            "ce transition types whose transition relations are constructed",
+            "[monolithic, var_based_conjunctive, dynamic]");
+        add_option<int>(
+            "layers", "number of fw and bw layers", "10",
+            plugins::Bounds("0", "infinity"));
+        add_option<shared_ptr<SearchAlgorithm>>(
+            "reconstruction_search",
+            "symbolic search whose plan reconstruction is measured (e.g., "
+            "symk_fw(plan_selection=top_k(num_plans=100)))",
+            plugins::ArgumentInfo::NO_DEFAULT);
+        add_option<string>(
+            "output", "file with one JSON line per measurement",
+            "\"benchmark.jsonl\"");
+    }
+};
+
+static plugins::FeaturePlugin<SymbolicBenchmarkFeature> _plugin;
+}
+
+int main(int argc, const char **argv) {
+    try {
+        utils::register_event_handlers();
+        if (argc < 2) {
+            utils::g_log << get_usage(argv[0]) << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+
+        bool unit_cost = false;
+        if (static_cast<string>(argv[1]) != "--help") {
+            tasks::read_root_task(cin);
+            TaskProxy task_proxy(*tasks::g_root_task);
+            unit_cost = task_properties::is_unit_cost(task_proxy);
+        }
+
+        shared_ptr<SearchAlgorithm> benchmark =
+            parse_cmd_line(argc, argv, unit_cost);
+        benchmark->search();
+        utils::exit_with(utils::ExitCode::SUCCESS);
+    } catch (const utils::ExitException &e) {
+        return static_cast<int>(e.get_exitcode());
+    }
+}
@@ -3,9 +3,16 @@
 #include "sym_state_space_manager.h"
 #include "sym_utils.h"
 
+#include "sym_cache.h"
+
 #include "plan_reconstruction/sym_solution_registry.h"
 
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
 #include <cassert>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -14,14 +21,33 @@
 using namespace std;
 
 namespace symbolic {
-ClosedList::ClosedList() : mgr(nullptr) {
+ClosedList::ClosedList()
+    : mgr(nullptr),
+      max_layers(0),
+      compacted_max_g(-1),
+      spill_layers(0),
+      loaded_h(-1) {
 }
 
-void ClosedList::init(SymStateSpaceManager *manager) {
+ClosedList::~ClosedList() {
+    for (const auto &spilled_h : spilled) {
+        remove(get_spill_file(spilled_h.first).c_str());
+    }
+    if (!spill_dir.empty()) {
+        // Fails if the other direction still has files in it
+        error_code ec;
+        filesystem::remove(spill_dir, ec);
+    }
+}
+
+void ClosedList::init(SymStateSpaceManager *manager, int max_layers) {
     mgr = manager;
     map<int, vector<BDD>>().swap(zeroCostClosed);
     map<int, BDD>().swap(closed);
     closedTotal = mgr->zeroBDD();
+    this->max_layers = max_layers;
+    compacted = infinity();
+    compacted_max_g = -1;
 }
 
 void ClosedList::init(SymStateSpaceManager *manager, const ClosedList &other) {
@@ -29,41 +55,261 @@ void ClosedList::init(SymStateSpaceManager *manager, const ClosedList &other) {
     map<int, vector<BDD>>().swap(zeroCostClosed);
     map<int, BDD>().swap(closed);
     closedTotal = mgr->zeroBDD();
+    max_layers = 0;
+    compacted = infinity();
+    compacted_max_g = -1;
+    care_set = other.care_set;
 
     closedTotal = other.closedTotal;
     closed[0] = closedTotal;
 }
 
+/*
+ * The planner is killed on the time or memory limit without running the
+ * destructors, so the subdirectories of runs that are no longer running are
+ * removed when the next run starts to spill.
+ */
+static void remove_killed_runs(const string &directory) {
+    error_code ec;
+    for (const auto &entry : filesystem::directory_iterator(directory, ec)) {
+        string name = entry.path().filename().string();
+        if (!entry.is_directory(ec) || name.empty() || name.size() > 9 ||
+            name.find_first_not_of("0123456789") != string::npos) {
+            continue;
+        }
+        int pid = stoi(name);
+        if (pid != utils::get_process_id() && !utils::is_process_running(pid)) {
+            filesystem::remove_all(entry.path(), ec);
+            utils::g_log << "Removed closed layers of killed run: "
+                         << entry.path().string() << endl;
+        }
+    }
+}
+
+void ClosedList::set_spilling(
+    int num_layers, const string &directory, const string &name) {
+    remove_killed_runs(directory);
+    string run_dir = directory + "/" + to_string(utils::get_process_id());
+    error_code ec;
+    filesystem::create_directories(run_dir, ec);
+    if (ec) {
+        utils::g_log << "Could not create directory " << run_dir
+                     << " for the closed layers: " << ec.message() << endl;
+        return;
+    }
+    spill_layers = num_layers;
+    spill_dir = run_dir;
+    spill_prefix = spill_dir + "/closed_" + name + "_";
+}
+
+string ClosedList::get_spill_file(int h) const {
+    return spill_prefix + to_string(h) + ".bdd";
+}
+
+void ClosedList::spill(int h) {
+    vector<BDD> bdds{closed.at(h)};
+    if (zeroCostClosed.count(h)) {
+        bdds.insert(
+            bdds.end(), zeroCostClosed.at(h).begin(),
+            zeroCostClosed.at(h).end());
+    }
+    if (!SymCache::write_bdd_file(
+            *mgr->get_sym_vars(), get_spill_file(h), bdds)) {
+        // Keep the layers in memory
+        utils::g_log << "Could not write " << get_spill_file(h)
+                     << ": closed layers are no longer spilled" << endl;
+        spill_layers = 0;
+        return;
+    }
+    spilled[h] = bdds.size() - 1;
+    closed.erase(h);
+    zeroCostClosed.erase(h);
+}
+
+void ClosedList::unspill(int h) {
+    vector<BDD> bdds = load(h);
+    closed[h] = bdds[0];
+    if (bdds.size() > 1) {
+        zeroCostClosed[h].assign(bdds.begin() + 1, bdds.end());
+    }
+    remove(get_spill_file(h).c_str());
+    spilled.erase(h);
+    loaded_h = -1;
+    loaded.clear();
+}
+
+const vector<BDD> &ClosedList::load(int h) const {
+    if (loaded_h != h) {
+        if (!SymCache::read_bdd_file(
+                *mgr->get_sym_vars(), get_spill_file(h), spilled.at(h) + 1,
+                loaded)) {
+            cerr << "Could not read closed layer " << get_spill_file(h) << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        loaded_h = h;
+    }
+    return loaded;
+}
+
+BDD ClosedList::get_spilled_states(const BDD &cut_candidate) const {
+    if (spilled.empty()) {
+        return mgr->zeroBDD();
+    }
+    BDD res = cut_candidate;
+    for (const auto &closedH : closed) {
+        res *= !closedH.second;
+    }
+    return res;
+}
+
 void ClosedList::insert(int h, BDD S) {
-    if (closed.count(h)) {
-        closed[h] += S;
+    if (spilled.count(h)) {
+        unspill(h);
+    }
+    if (h <= compacted_max_g) {
+        compact(h, S);
+    } else if (closed.count(h)) {
+        closed[h] = simplify(closed[h] + S);
     } else {
-        closed[h] = S;
+        closed[h] = simplify(S);
     }
 
     if (mgr->has_zero_cost_transition()) {
         zeroCostClosed[h].push_back(S);
     }
-    closedTotal += S;
+    closedTotal = simplify(closedTotal + S);
+
+    while (max_layers > 0 && static_cast<int>(closed.size()) > max_layers) {
+        compact(closed.begin()->first, closed.begin()->second);
+        closed.erase(closed.begin());
+    }
+    while (spill_layers > 0 &&
+           static_cast<int>(closed.size() - closed.count(0)) > spill_layers) {
+        spill(next(closed.begin(), closed.count(0))->first);
+    }
+}
+
+BDD ClosedList::simplify(BDD bdd) const {
+    for (const BDD &care : care_set) {
+        bdd = bdd.Restrict(care);
+    }
+    return bdd;
+}
+
+BDD ClosedList::make_exact(BDD bdd) const {
+    for (const BDD &care : care_set) {
+        bdd *= care;
+    }
+    return bdd;
+}
+
+void ClosedList::compact(int h, const BDD &S) {
+    compacted = compacted.Minimum(S.Add().Ite(mgr->constant(h), infinity()));
+    compacted_max_g = max(compacted_max_g, h);
+}
+
+ADD ClosedList::get_compacted_costs(const BDD &states) const {
+    return states.Add().Ite(compacted, infinity());
+}
+
+BDD ClosedList::get_closed_at(int h) const {
+    if (h <= compacted_max_g) {
+        return make_exact(compacted.BddInterval(h, h));
+    }
+    if (spilled.count(h)) {
+        return make_exact(load(h)[0]);
+    }
+    if (!closed.count(h)) {
+        return mgr->zeroBDD();
+    }
+    return make_exact(closed.at(h));
+}
+
+BDD ClosedList::get_zero_closed_at(int h, int layer) const {
+    if (spilled.count(h)) {
+        return load(h).at(layer + 1);
+    }
+    return zeroCostClosed.at(h).at(layer);
+}
+
+size_t ClosedList::get_num_zero_closed_layers(int h) const {
+    if (spilled.count(h)) {
+        return spilled.at(h);
+    }
+    if (zeroCostClosed.count(h) == 0) {
+        return 0;
+    }
+    return zeroCostClosed.at(h).size();
+}
+
+size_t ClosedList::get_zero_cut(int h, BDD bdd) const {
+    size_t i = 0;
+    for (; i < get_num_zero_closed_layers(h); i++) {
+        BDD intersection = get_zero_closed_at(h, i) * bdd;
+        if (!intersection.IsZero()) {
+            break;
+        }
+    }
+    return i;
 }
 
 BDD ClosedList::getPartialClosed(int upper_bound) const {
     BDD res = mgr->zeroBDD();
+    if (compacted_max_g >= 0) {
+        res = compacted.BddInterval(0, upper_bound);
+    }
+    for (const auto &spilled_h : spilled) {
+        if (spilled_h.first <= upper_bound) {
+            res += load(spilled_h.first)[0];
+        }
+    }
     for (const auto &pair : closed) {
         if (pair.first > upper_bound) {
             break;
         }
         res += pair.second;
     }
-    return res;
+    return make_exact(res);
 }
 
 SymSolutionCut ClosedList::getCheapestCut(BDD states, int g, bool fw) const {
-    BDD cut_candidate = states * closedTotal;
+    BDD cut_candidate = make_exact(states * closedTotal);
     if (cut_candidate.IsZero()) {
         return SymSolutionCut();
     }
 
+    if (compacted_max_g >= 0) {
+        ADD costs = get_compacted_costs(cut_candidate);
+        double min_cost = Cudd_V(costs.FindMin().getNode());
+        if (min_cost != numeric_limits<double>::infinity()) {
+            int h = static_cast<int>(min_cost);
+            BDD cut = costs.BddInterval(h, h);
+            if (fw) {
+                return SymSolutionCut(g, h, cut);
+            } else {
+                return SymSolutionCut(h, g, cut);
+            }
+        }
+    }
+
+    // Spilled layers are cheaper than the layers in memory except for the
+    // one of cost 0, so they are only loaded if they contain the cut.
+    BDD spilled_cut = get_spilled_states(cut_candidate);
+    if (!spilled_cut.IsZero() &&
+        (!closed.count(0) || (closed.at(0) * cut_candidate).IsZero())) {
+        for (const auto &spilled_h : spilled) {
+            int h = spilled_h.first;
+            BDD cut = load(h)[0] * spilled_cut;
+            if (!cut.IsZero()) {
+                if (fw) {
+                    return SymSolutionCut(g, h, cut);
+                } else {
+                    return SymSolutionCut(h, g, cut);
+                }
+            }
+        }
+    }
+
     for (const auto &closedH : closed) {
         int h = closedH.first;
 
@@ -84,7 +330,43 @@ SymSolutionCut ClosedList::getCheapestCut(BDD states, int g, bool fw) const {
 vector<SymSolutionCut> ClosedList::getAllCuts(
     BDD states, int g, bool fw, int lower_bound) const {
     vector<SymSolutionCut> result;
-    BDD cut_candidate = states * closedTotal;
+    BDD cut_candidate = make_exact(states * closedTotal);
+    if (!cut_candidate.IsZero() && compacted_max_g >= 0) {
+        // Extract the cuts of the compacted layers by increasing cost
+        ADD costs = get_compacted_costs(cut_candidate);
+        double min_cost = Cudd_V(costs.FindMin().getNode());
+        while (min_cost != numeric_limits<double>::infinity()) {
+            int h = static_cast<int>(min_cost);
+            BDD cut = costs.BddInterval(h, h);
+            if (g + h >= lower_bound) {
+                if (fw) {
+                    result.emplace_back(g, h, cut);
+                } else {
+                    result.emplace_back(h, g, cut);
+                }
+            }
+            costs = (!cut).Add().Ite(costs, infinity());
+            min_cost = Cudd_V(costs.FindMin().getNode());
+        }
+    }
+    BDD spilled_cut = get_spilled_states(cut_candidate);
+    for (const auto &spilled_h : spilled) {
+        int h = spilled_h.first;
+        if (spilled_cut.IsZero()) {
+            break;
+        }
+        if (g + h < lower_bound) {
+            continue;
+        }
+        BDD cut = load(h)[0] * spilled_cut;
+        if (!cut.IsZero()) {
+            if (fw) {
+                result.emplace_back(g, h, cut);
+            } else {
+                result.emplace_back(h, g, cut);
+            }
+        }
+    }
     if (!cut_candidate.IsZero()) {
         for (const auto &closedH : closed) {
             int h = closedH.first;
@@ -6,8 +6,10 @@
 
 #include "searches/uniform_cost_search.h"
 
+#include <limits>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace symbolic {
@@ -21,6 +23,22 @@ private:
 
     std::map<int, BDD> closed; // Mapping from cost to set of states
 
+    // If each state is closed with a single cost, only the last max_layers
+    // layers are kept as separate BDDs. Older layers are compacted into an
+    // ADD that maps each state to its cost (and non-closed ones to infinity),
+    // so that the cheapest cost of a set of states is found with a single
+    // ADD operation instead of a scan over all layers.
+    int max_layers; // 0 disables the compaction
+    ADD compacted;
+    int compacted_max_g; // Largest compacted cost or -1
+
+    ADD infinity() const {
+        return mgr->constant(std::numeric_limits<double>::infinity());
+    }
+    void compact(int h, const BDD &S);
+    // Closed costs of the given states (infinity for the others)
+    ADD get_compacted_costs(const BDD &states) const;
+
     // Auxiliar BDDs for the number of 0-cost action steps
     // ALERT: The information here might be wrong
     // It is just used to extract path more quickly, but the information
@@ -28,11 +46,58 @@ private:
     std::map<int, std::vector<BDD>> zeroCostClosed;
     BDD closedTotal; // All closed states.
 
+    // If not empty, the closed BDDs are simplified with Restrict wrt. these
+    // invariants (e.g., not mutex states), so they are only exact for states
+    // that satisfy them. Such states are irrelevant for any plan, so
+    // filtering with notClosed() remains sound. Cuts and the closed layers
+    // used to reconstruct plans are conjoined with the invariants to be
+    // exact.
+    std::vector<BDD> care_set;
+
+    BDD simplify(BDD bdd) const;
+    BDD make_exact(BDD bdd) const;
+
+    // If spill_layers > 0, only the last spill_layers layers are kept in
+    // memory. Older layers (with their zero-cost layers) are written to disk
+    // and loaded again when they are needed, i.e., for cuts with old layers
+    // and to reconstruct plans. closedTotal remains in memory, so duplicate
+    // detection does not need the spilled layers. The layer of cost 0 (the
+    // start states) is never spilled. Only used if each state is closed with
+    // a single cost and the layers are not compacted.
+    int spill_layers;
+    // Directory of the files of this run (a subdirectory of the spill
+    // directory named after the process id)
+    std::string spill_dir;
+    std::string spill_prefix; // Path of the files without the cost
+    std::map<int, int> spilled; // Cost -> number of zero-cost layers
+    // Last spilled layer loaded from disk: the closed BDD followed by its
+    // zero-cost layers (-1 if none)
+    mutable int loaded_h;
+    mutable std::vector<BDD> loaded;
+
+    std::string get_spill_file(int h) const;
+    void spill(int h);
+    void unspill(int h);
+    const std::vector<BDD> &load(int h) const;
+    // States of the (exact) candidate that are not in a layer in memory
+    BDD get_spilled_states(const BDD &cut_candidate) const;
+
 public:
     ClosedList();
-    void init(SymStateSpaceManager *manager);
+    ~ClosedList();
+    void init(SymStateSpaceManager *manager, int max_layers = 0);
     void init(SymStateSpaceManager *manager, const ClosedList &other);
 
+    void set_care_set(const std::vector<BDD> &care) {
+        care_set = care;
+    }
+
+    // Spills all but the last num_layers layers to files in a subdirectory
+    // of the directory for this run. The subdirectories of killed runs are
+    // removed here.
+    void set_spilling(
+        int num_layers, const std::string &directory, const std::string &name);
+
     void insert(int h, BDD S);
 
     BDD getPartialClosed(int upper_bound) const;
@@ -43,13 +108,14 @@ public:
         BDD states, int g, bool fw, int lower_bound) const;
 
     inline BDD getClosed() const {
-        return closedTotal;
+        return make_exact(closedTotal);
     }
 
     BDD notClosed() const {
         return !closedTotal;
     }
 
+    // Note: does not contain the compacted and spilled layers
     inline std::map<int, BDD> getClosedList() const {
         return closed;
     }
@@ -61,36 +127,11 @@ public:
         return get_zero_closed_at(0, 0);
     }
 
-    inline BDD get_closed_at(int h) const {
-        if (!closed.count(h)) {
-            return mgr->zeroBDD();
-        }
-        return closed.at(h);
-    }
+    BDD get_closed_at(int h) const;
 
-    inline BDD get_zero_closed_at(int h, int layer) const {
-        return zeroCostClosed.at(h).at(layer);
-    }
-
-    inline size_t get_num_zero_closed_layers(int h) const {
-        if (zeroCostClosed.count(h) == 0) {
-            return 0;
-        }
-        return zeroCostClosed.at(h).size();
-    }
-
-    inline size_t get_zero_cut(int h, BDD bdd) const {
-        size_t i = 0;
-        if (get_num_zero_closed_layers(h)) {
-            for (; i < zeroCostClosed.at(h).size(); i++) {
-                BDD intersection = zeroCostClosed.at(h).at(i) * bdd;
-                if (!intersection.IsZero()) {
-                    break;
-                }
-            }
-        }
-        return i;
-    }
+    BDD get_zero_closed_at(int h, int layer) const;
+    size_t get_num_zero_closed_layers(int h) const;
+    size_t get_zero_cut(int h, BDD bdd) const;
 };
 }
 
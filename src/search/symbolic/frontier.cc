@@ -1,13 +1,17 @@
 #include "frontier.h"
 
-#include "sym_state_space_manager.h"
-
 #include "../utils/timer.h"
 
 using namespace std;
 
 namespace symbolic {
-Frontier::Frontier() : mgr(nullptr), g_value(0) {
+Frontier::Frontier()
+    : mgr(nullptr),
+      num_imaged(0),
+      num_splits(0),
+      g_value(0),
+      filter_time(0),
+      merge_time(0) {
 }
 
 void Frontier::init(SymStateSpaceManager *mgr_, const BDD &bdd) {
@@ -29,6 +33,7 @@ bool Frontier::nextStepZero() const {
 Result Frontier::prepare(
     int maxTime, int maxNodes, bool fw, bool initialization) {
     utils::Timer filterTime;
+    filter_time = merge_time = 0;
     if (!Sfilter.empty()) {
         int numFiltered = mgr->filterMutexBucket(
             Sfilter, fw, initialization, maxTime, maxNodes);
@@ -40,13 +45,16 @@ Result Frontier::prepare(
             Bucket().swap(Sfilter);
         } else {
             Sfilter.erase(Sfilter.begin(), Sfilter.begin() + numFiltered);
-            return Result(TruncatedReason::FILTER_MUTEX, filterTime());
+            filter_time = filterTime();
+            return Result(TruncatedReason::FILTER_MUTEX, filter_time);
         }
     }
+    filter_time = filterTime();
 
+    utils::Timer merge_timer;
     if (!Smerge.empty()) {
         if (Smerge.size() > 1) {
-            mgr->merge_bucket(Smerge, 60000, 10000000);
+            mgr->merge_frontier_bucket(Smerge);
         }
 
         if (mgr->has_zero_cost_transition()) {
@@ -58,12 +66,14 @@ Result Frontier::prepare(
         }
     }
 
-    // If there are zero cost operators, merge S
-    if (mgr->has_zero_cost_transition() && Szero.empty()) {
+    // If there are zero cost operators, merge S (unless its expansion has
+    // already started)
+    if (mgr->has_zero_cost_transition() && Szero.empty() && Simg.empty()) {
         if (S.size() > 1) {
-            mgr->merge_bucket(S, 60000, 10000000);
+            mgr->merge_frontier_bucket(S);
         }
     }
+    merge_time = merge_timer();
 
     return Result(filterTime());
 }
@@ -100,23 +110,67 @@ int Frontier::buckets() const {
     }
 }
 
+void Frontier::trace_nodes(SymTrace &trace) const {
+    if (!Sfilter.empty())
+        trace.set("Sfilter", static_cast<long>(nodeCount(Sfilter)));
+    if (!Smerge.empty())
+        trace.set("Smerge", static_cast<long>(nodeCount(Smerge)));
+    if (!Szero.empty())
+        trace.set("Szero", static_cast<long>(nodeCount(Szero)));
+    if (!S.empty())
+        trace.set("S", static_cast<long>(nodeCount(S)));
+}
+
+/*
+ * The part where the top variable is true keeps the partial image of the BDD.
+ * The transition relations applied so far covered both parts, so both of
+ * them continue with the progress of the original BDD.
+ */
+bool Frontier::split(Bucket &bucket) {
+    if (num_splits >= mgr->get_max_frontier_splits() ||
+        !mgr->node_limit_exceeded()) {
+        return false;
+    }
+    BDD pos, neg;
+    if (!mgr->split_by_top_variable(bucket[num_imaged], pos, neg)) {
+        return false;
+    }
+    ++num_splits;
+    bucket[num_imaged] = pos;
+    bucket.insert(bucket.begin() + num_imaged + 1, neg);
+    Simg.insert(Simg.begin() + num_imaged + 1, map<int, Bucket>());
+    image_progress.insert(
+        image_progress.begin() + num_imaged + 1, image_progress[num_imaged]);
+    return true;
+}
+
 ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
     // Image with respect to 0-cost actions
     utils::Timer image_time;
+    Simg.resize(Szero.size());
+    image_progress.resize(Szero.size());
 
     mgr->set_time_limit(maxTime);
     // Compute image, storing the result on Simg
-    try {
-        for (size_t i = 0; i < Szero.size(); i++) {
-            Simg.push_back(map<int, Bucket>());
-            mgr->zero_image(fw, Szero[i], Simg[i][0], maxNodes);
+    while (num_imaged < Szero.size()) {
+        try {
+            mgr->zero_image(
+                fw, Szero[num_imaged], Simg[num_imaged][0], maxNodes,
+                image_progress[num_imaged]);
+            num_imaged++;
+        } catch (const BDDError &e) {
+            if (!split(Szero)) {
+                mgr->unset_time_limit();
+                return ResultExpansion(
+                    true, TruncatedReason::IMAGE_ZERO, image_time());
+            }
         }
-        mgr->unset_time_limit();
-    } catch (const BDDError &e) {
-        mgr->unset_time_limit();
-        return ResultExpansion(true, TruncatedReason::IMAGE_ZERO, image_time());
     }
+    mgr->unset_time_limit();
 
+    num_imaged = 0;
+    num_splits = 0;
+    image_progress.clear();
     Bucket().swap(Szero); // Delete Szero because it has been expanded
 
     return ResultExpansion(true, Simg, image_time());
@@ -124,22 +178,30 @@ ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
 
 ResultExpansion Frontier::expand_cost(int maxTime, int maxNodes, bool fw) {
     utils::Timer image_time;
+    Simg.resize(S.size());
+    image_progress.resize(S.size());
     mgr->set_time_limit(maxTime);
     // cout << maxTime << " + " << maxNodes << endl;
-    try {
-        for (size_t i = 0; i < S.size(); i++) {
-            Simg.push_back(map<int, Bucket>());
-            mgr->cost_image(fw, S[i], Simg[i], maxNodes);
+    while (num_imaged < S.size()) {
+        try {
+            mgr->cost_image(
+                fw, S[num_imaged], Simg[num_imaged], maxNodes,
+                image_progress[num_imaged]);
+            num_imaged++;
+        } catch (const BDDError &e) {
+            if (!split(S)) {
+                // Update estimation
+                mgr->unset_time_limit();
+                return ResultExpansion(
+                    false, TruncatedReason::IMAGE_COST, image_time());
+            }
         }
-        mgr->unset_time_limit();
-    } catch (const BDDError &e) {
-        // Update estimation
-        mgr->unset_time_limit();
-
-        return ResultExpansion(
-            false, TruncatedReason::IMAGE_COST, image_time());
     }
+    mgr->unset_time_limit();
 
+    num_imaged = 0;
+    num_splits = 0;
+    image_progress.clear();
     Bucket().swap(S); // Delete Szero because it has been expanded
     return ResultExpansion(false, Simg, image_time());
 }
@@ -2,6 +2,8 @@
 #define SYMBOLIC_FRONTIER_H
 
 #include "sym_bucket.h"
+#include "sym_state_space_manager.h"
+#include "sym_trace.h"
 
 #include "searches/sym_search.h"
 
@@ -9,7 +11,6 @@
 #include <map>
 
 namespace symbolic {
-class SymStateSpaceManager;
 
 class Result {
 public:
@@ -51,10 +52,21 @@ class Frontier { // Current states extracted from the open list
     // bucket to store temporary image results in expand_zero() and
     // expand_cost() For each BDD in Szero or S, stores a map with pairs <cost,
     // resImage>
+    // If an expansion is truncated, Simg keeps the images computed so far and
+    // the expansion is resumed with Szero[num_imaged] or S[num_imaged].
     std::vector<std::map<int, Bucket>> Simg;
+    std::vector<ImageProgress> image_progress; // One per BDD of Simg
+    size_t num_imaged;
+    int num_splits; // BDDs split in the current expansion
+
+    // Splits bucket[num_imaged] if its image exceeded the node limit.
+    bool split(Bucket &bucket);
 
     int g_value;
 
+    // Time (s) spent filtering and merging in the last call to prepare
+    double filter_time, merge_time;
+
     ResultExpansion expand_zero(int maxTime, int maxNodes, bool fw);
     ResultExpansion expand_cost(int maxTime, int maxNodes, bool fw);
 
@@ -74,6 +86,16 @@ public:
     int nodes() const;
     int buckets() const;
 
+    // Sets the node counts of the non-empty buckets in the trace
+    void trace_nodes(SymTrace &trace) const;
+
+    double get_filter_time() const {
+        return filter_time;
+    }
+    double get_merge_time() const {
+        return merge_time;
+    }
+
     int g() const {
         return g_value;
     }
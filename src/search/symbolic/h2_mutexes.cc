@@ -0,0 +1,263 @@
+#include "h2_mutexes.h"
+
+#include "../task_proxy.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace symbolic {
+static void sort_unique(vector<int> &vec) {
+    sort(vec.begin(), vec.end());
+    vec.erase(unique(vec.begin(), vec.end()), vec.end());
+}
+
+H2Mutexes::H2Mutexes(const shared_ptr<AbstractTask> &task)
+    : task(task), num_facts(0) {
+    for (int var = 0; var < task->get_num_variables(); ++var) {
+        fact_offset.push_back(num_facts);
+        num_facts += task->get_variable_domain_size(var);
+        fact_var.resize(num_facts, var);
+    }
+    num_words = (num_facts + 63) / 64;
+}
+
+void H2Mutexes::clear_var(vector<uint64_t> &bits, int var) const {
+    int end = fact_offset[var] + task->get_variable_domain_size(var);
+    for (int q = fact_offset[var]; q < end; ++q) {
+        bits[q / 64] &= ~(uint64_t(1) << (q % 64));
+    }
+}
+
+void H2Mutexes::set_reached_fact(int p) {
+    reached[num_facts][p / 64] |= uint64_t(1) << (p % 64);
+    reached[p][p / 64] |= uint64_t(1) << (p % 64);
+}
+
+vector<H2Mutexes::H2Operator> H2Mutexes::get_operators(bool fw) const {
+    TaskProxy task_proxy(*task);
+    vector<H2Operator> operators;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        H2Operator h2_op;
+        vector<int> pre_value(task->get_num_variables(), -1);
+        for (FactProxy pre : op.get_preconditions()) {
+            pre_value[pre.get_variable().get_id()] = pre.get_value();
+        }
+
+        if (fw) {
+            for (FactProxy pre : op.get_preconditions()) {
+                h2_op.pre.push_back(get_fact(pre.get_pair()));
+            }
+            for (EffectProxy eff : op.get_effects()) {
+                FactPair fact = eff.get_fact().get_pair();
+                h2_op.add.push_back(get_fact(fact));
+                // A conditional effect may not be triggered, so the variable
+                // may keep its value.
+                if (eff.get_conditions().empty()) {
+                    h2_op.changed_vars.push_back(fact.var);
+                }
+            }
+        } else {
+            // Regression: the effects must hold before regressing, and the
+            // changed variables take the value of their precondition (any
+            // value if there is none).
+            vector<bool> changed(task->get_num_variables(), false);
+            for (EffectProxy eff : op.get_effects()) {
+                FactPair fact = eff.get_fact().get_pair();
+                h2_op.pre.push_back(get_fact(fact));
+                h2_op.changed_vars.push_back(fact.var);
+                changed[fact.var] = true;
+            }
+            for (FactProxy pre : op.get_preconditions()) {
+                FactPair fact = pre.get_pair();
+                if (changed[fact.var]) {
+                    h2_op.add.push_back(get_fact(fact));
+                } else {
+                    h2_op.pre.push_back(get_fact(fact));
+                }
+            }
+            for (int var : h2_op.changed_vars) {
+                if (pre_value[var] == -1) {
+                    for (int val = 0; val < task->get_variable_domain_size(var);
+                         ++val) {
+                        h2_op.add.push_back(get_fact(FactPair(var, val)));
+                    }
+                }
+            }
+        }
+        sort_unique(h2_op.pre);
+        sort_unique(h2_op.add);
+        sort_unique(h2_op.changed_vars);
+        operators.push_back(move(h2_op));
+    }
+    return operators;
+}
+
+void H2Mutexes::init_reached(bool fw) {
+    TaskProxy task_proxy(*task);
+    reached.assign(num_facts + 1, vector<uint64_t>(num_words, 0));
+    if (fw) {
+        vector<int> facts;
+        State initial_state = task_proxy.get_initial_state();
+        for (size_t var = 0; var < initial_state.size(); ++var) {
+            facts.push_back(get_fact(initial_state[var].get_pair()));
+        }
+        for (int p : facts) {
+            set_reached_fact(p);
+            for (int q : facts) {
+                set(p, q);
+            }
+        }
+    } else {
+        // Any state that satisfies the goal
+        vector<int> goal_value(task->get_num_variables(), -1);
+        for (FactProxy goal : task_proxy.get_goals()) {
+            goal_value[goal.get_variable().get_id()] = goal.get_value();
+        }
+        for (int p = 0; p < num_facts; ++p) {
+            int goal_val = goal_value[fact_var[p]];
+            if (goal_val == -1 || goal_val == get_fact_pair(p).value) {
+                set_reached_fact(p);
+            }
+        }
+        for (int p = 0; p < num_facts; ++p) {
+            if (test(p, p)) {
+                reached[p] = reached[num_facts];
+                clear_var(reached[p], fact_var[p]);
+                set_reached_fact(p);
+            }
+        }
+    }
+}
+
+bool H2Mutexes::is_applicable(const H2Operator &op) const {
+    for (size_t i = 0; i < op.pre.size(); ++i) {
+        for (size_t j = i; j < op.pre.size(); ++j) {
+            if (!test(op.pre[i], op.pre[j])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool H2Mutexes::apply(const H2Operator &op, vector<uint64_t> &compatible) {
+    // Facts that may hold together with the added facts
+    compatible = reached[num_facts];
+    for (int p : op.pre) {
+        for (int w = 0; w < num_words; ++w) {
+            compatible[w] &= reached[p][w];
+        }
+    }
+    for (int var : op.changed_vars) {
+        clear_var(compatible, var);
+    }
+
+    bool updated = false;
+    for (int p : op.add) {
+        if (!test(p, p)) {
+            set_reached_fact(p);
+            updated = true;
+        }
+        for (int q : op.add) {
+            if (fact_var[q] != fact_var[p] && !test(p, q)) {
+                set(p, q);
+                updated = true;
+            }
+        }
+        for (int w = 0; w < num_words; ++w) {
+            uint64_t new_bits = compatible[w] & ~reached[p][w];
+            for (int q = w * 64; new_bits; ++q, new_bits >>= 1) {
+                if ((new_bits & 1) && fact_var[q] != fact_var[p]) {
+                    set(p, q);
+                    updated = true;
+                }
+            }
+        }
+    }
+    return updated;
+}
+
+bool H2Mutexes::compute_fixpoint(bool fw, const utils::CountdownTimer &timer) {
+    vector<H2Operator> operators = get_operators(fw);
+    init_reached(fw);
+
+    vector<bool> triggered(operators.size(), false);
+    vector<uint64_t> compatible;
+    bool updated = true;
+    while (updated) {
+        updated = false;
+        for (size_t i = 0; i < operators.size(); ++i) {
+            if (i % 1000 == 0 && timer.is_expired()) {
+                return false;
+            }
+            if (!triggered[i]) {
+                if (!is_applicable(operators[i])) {
+                    continue;
+                }
+                triggered[i] = true;
+            }
+            updated |= apply(operators[i], compatible);
+        }
+    }
+    return true;
+}
+
+void H2Mutexes::add_mutexes(
+    bool fw, vector<MutexGroup> &mutex_groups,
+    vector<FactPair> &unreachable_facts) const {
+    int num_mutexes = 0;
+    int num_unreachable = 0;
+    for (int p = 0; p < num_facts; ++p) {
+        if (!test(p, p)) {
+            unreachable_facts.push_back(get_fact_pair(p));
+            ++num_unreachable;
+            continue;
+        }
+        for (int q = p + 1; q < num_facts; ++q) {
+            if (fact_var[q] != fact_var[p] && test(q, q) && !test(p, q)) {
+                mutex_groups.emplace_back(
+                    vector<FactPair>{get_fact_pair(p), get_fact_pair(q)}, fw);
+                ++num_mutexes;
+            }
+        }
+    }
+    utils::g_log << "h^2 mutexes " << (fw ? "fw" : "bw") << ": "
+                 << num_mutexes << " pairs, " << num_unreachable
+                 << " unreachable facts" << endl;
+}
+
+void H2Mutexes::compute(
+    double max_time, vector<MutexGroup> &mutex_groups,
+    vector<FactPair> &unreachable_facts_fw,
+    vector<FactPair> &unreachable_facts_bw) {
+    TaskProxy task_proxy(*task);
+    if (task_properties::has_axioms(task_proxy)) {
+        utils::g_log << "h^2 mutexes are not computed for tasks with axioms"
+                     << endl;
+        return;
+    }
+
+    utils::CountdownTimer timer(max_time);
+    // Mutexes detected fw prune the bw search and vice versa
+    if (compute_fixpoint(true, timer)) {
+        add_mutexes(true, mutex_groups, unreachable_facts_bw);
+    } else {
+        utils::g_log << "h^2 mutexes fw: time limit exceeded" << endl;
+    }
+    if (task_properties::has_conditional_effects(task_proxy)) {
+        utils::g_log << "h^2 mutexes bw are not computed for tasks with "
+                     << "conditional effects" << endl;
+    } else if (compute_fixpoint(false, timer)) {
+        add_mutexes(false, mutex_groups, unreachable_facts_fw);
+    } else {
+        utils::g_log << "h^2 mutexes bw: time limit exceeded" << endl;
+    }
+    utils::g_log << "h^2 mutex time: " << timer.get_elapsed_time() << endl;
+    vector<vector<uint64_t>>().swap(reached);
+}
+}
@@ -0,0 +1,88 @@
+#ifndef SYMBOLIC_H2_MUTEXES_H
+#define SYMBOLIC_H2_MUTEXES_H
+
+#include "../abstract_task.h"
+#include "../mutex_group.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace symbolic {
+/*
+ * Computes h^2 mutexes of the SAS+ task directly in the search component,
+ * without running the h2 preprocessor. The reachable fact pairs are stored
+ * as one bitset per fact. An operator whose preconditions are pairwise
+ * reachable makes each added fact reachable together with the other added
+ * facts and with all facts that are compatible with every precondition and
+ * are not changed by the operator (a word-wise AND of the precondition rows).
+ *
+ * Forward mutexes are not reachable from the initial state, so they prune
+ * the backward search. Backward mutexes cannot reach the goal, so they prune
+ * the forward search. Conditional effects are over-approximated forward
+ * (their conditions are ignored); backward mutexes are not computed for
+ * tasks with conditional effects, and no mutexes are computed for tasks
+ * with axioms. If the time limit is exceeded in one direction, no mutexes
+ * of that direction are reported.
+ */
+class H2Mutexes {
+    struct H2Operator {
+        std::vector<int> pre;
+        std::vector<int> add;
+        std::vector<int> changed_vars; // Facts of these vars are not kept
+    };
+
+    std::shared_ptr<AbstractTask> task;
+    std::vector<int> fact_offset; // Id of the first fact of each variable
+    std::vector<int> fact_var;
+    int num_facts;
+    int num_words;
+
+    // reached[p] has the bit q set iff the pair (p, q) is reachable. The last
+    // row holds the reachable facts.
+    std::vector<std::vector<uint64_t>> reached;
+
+    bool test(int p, int q) const {
+        return (reached[p][q / 64] >> (q % 64)) & 1;
+    }
+    void set(int p, int q) {
+        reached[p][q / 64] |= uint64_t(1) << (q % 64);
+        reached[q][p / 64] |= uint64_t(1) << (p % 64);
+    }
+    void clear_var(std::vector<uint64_t> &bits, int var) const;
+    void set_reached_fact(int p);
+
+    int get_fact(const FactPair &fact) const {
+        return fact_offset[fact.var] + fact.value;
+    }
+    FactPair get_fact_pair(int p) const {
+        return FactPair(fact_var[p], p - fact_offset[fact_var[p]]);
+    }
+
+    std::vector<H2Operator> get_operators(bool fw) const;
+    void init_reached(bool fw);
+    bool is_applicable(const H2Operator &op) const;
+    bool apply(const H2Operator &op, std::vector<uint64_t> &compatible);
+    bool compute_fixpoint(bool fw, const utils::CountdownTimer &timer);
+    void add_mutexes(
+        bool fw, std::vector<MutexGroup> &mutex_groups,
+        std::vector<FactPair> &unreachable_facts) const;
+
+public:
+    explicit H2Mutexes(const std::shared_ptr<AbstractTask> &task);
+
+    // Adds the pairs of facts that are h^2 mutex as mutex groups of size two.
+    // Facts that are not reachable at all are added to the unreachable facts
+    // of the search direction they prune (fw or bw).
+    void compute(
+        double max_time, std::vector<MutexGroup> &mutex_groups,
+        std::vector<FactPair> &unreachable_facts_fw,
+        std::vector<FactPair> &unreachable_facts_bw);
+};
+}
+
+#endif
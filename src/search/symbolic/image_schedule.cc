@@ -0,0 +1,142 @@
+#include "image_schedule.h"
+
+#include "sym_utils.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace symbolic {
+static vector<unsigned int> get_sorted_indices(const vector<BDD> &vars) {
+    vector<unsigned int> indices;
+    indices.reserve(vars.size());
+    for (const BDD &var : vars) {
+        indices.push_back(var.NodeReadIndex());
+    }
+    sort(indices.begin(), indices.end());
+    return indices;
+}
+
+bool ImageSchedule::TransitionGroup::matches(
+    const DisjunctiveTransitionRelation &tr) const {
+    return exists_vars == tr.get_exists_vars() &&
+           exists_bw_vars == tr.get_exists_bw_vars() &&
+           swap_indices == get_sorted_indices(tr.get_swap_vars());
+}
+
+void ImageSchedule::init(const map<int, vector<TransitionRelationPtr>> &trs) {
+    groups.clear();
+    ungrouped_transitions.clear();
+
+    for (const auto &[cost, tr_vec] : trs) {
+        for (const TransitionRelationPtr &tr : tr_vec) {
+            auto disj_tr =
+                dynamic_pointer_cast<DisjunctiveTransitionRelation>(tr);
+            if (disj_tr) {
+                add_transition(cost, disj_tr);
+            } else {
+                ungrouped_transitions[cost].push_back(tr);
+            }
+        }
+    }
+
+    // Order groups by the topmost variable they change (and then by the
+    // remaining ones), so that groups on neighbouring variables follow each
+    // other. Groups without changed variables come first.
+    for (auto &[cost, group_vec] : groups) {
+        stable_sort(
+            group_vec.begin(), group_vec.end(),
+            [](const TransitionGroup &g1, const TransitionGroup &g2) {
+                return g1.swap_indices < g2.swap_indices;
+            });
+    }
+}
+
+void ImageSchedule::add_transition(
+    int cost, const shared_ptr<DisjunctiveTransitionRelation> &tr) {
+    vector<TransitionGroup> &group_vec = groups[cost];
+    for (TransitionGroup &group : group_vec) {
+        if (group.matches(*tr)) {
+            group.transitions.push_back(tr);
+            return;
+        }
+    }
+
+    TransitionGroup group;
+    group.exists_vars = tr->get_exists_vars();
+    group.exists_bw_vars = tr->get_exists_bw_vars();
+    group.swap_vars = tr->get_swap_vars();
+    group.swap_vars_p = tr->get_swap_vars_p();
+    group.swap_indices = get_sorted_indices(group.swap_vars);
+    group.transitions.push_back(tr);
+    group_vec.push_back(move(group));
+}
+
+void ImageSchedule::group_image(
+    const TransitionGroup &group, const BDD &from, Bucket &res,
+    int max_nodes) const {
+    BalancedOr group_res(max_nodes);
+    for (const auto &tr : group.transitions) {
+        group_res.insert(
+            tr->get_tr_BDD().AndAbstract(from, group.exists_vars, max_nodes));
+    }
+
+    Bucket unswapped;
+    group_res.extract(unswapped);
+    for (const BDD &bdd : unswapped) {
+        res.push_back(bdd.SwapVariables(group.swap_vars, group.swap_vars_p));
+    }
+}
+
+void ImageSchedule::group_preimage(
+    const TransitionGroup &group, const BDD &from, Bucket &res,
+    int max_nodes) const {
+    BDD swapped = from.SwapVariables(group.swap_vars, group.swap_vars_p);
+    BalancedOr group_res(max_nodes);
+    for (const auto &tr : group.transitions) {
+        group_res.insert(tr->get_tr_BDD().AndAbstract(
+            swapped, group.exists_bw_vars, max_nodes));
+    }
+    group_res.extract(res);
+}
+
+void ImageSchedule::image(
+    bool fw, int cost, const BDD &from, Bucket &res, int max_nodes) const {
+    BalancedOr cost_res(max_nodes);
+
+    auto group_it = groups.find(cost);
+    if (group_it != groups.end()) {
+        Bucket group_res;
+        for (const TransitionGroup &group : group_it->second) {
+            if (fw) {
+                group_image(group, from, group_res, max_nodes);
+            } else {
+                group_preimage(group, from, group_res, max_nodes);
+            }
+            for (const BDD &bdd : group_res) {
+                cost_res.insert(bdd);
+            }
+            group_res.clear();
+        }
+    }
+
+    auto ungrouped_it = ungrouped_transitions.find(cost);
+    if (ungrouped_it != ungrouped_transitions.end()) {
+        for (const TransitionRelationPtr &tr : ungrouped_it->second) {
+            cost_res.insert(
+                fw ? tr->image(from, max_nodes)
+                   : tr->preimage(from, max_nodes));
+        }
+    }
+
+    cost_res.extract(res);
+}
+
+int ImageSchedule::num_groups() const {
+    int num = 0;
+    for (const auto &[cost, group_vec] : groups) {
+        num += group_vec.size();
+    }
+    return num;
+}
+}
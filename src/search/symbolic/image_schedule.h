@@ -0,0 +1,65 @@
+#ifndef SYMBOLIC_IMAGE_SCHEDULE_H
+#define SYMBOLIC_IMAGE_SCHEDULE_H
+
+#include "sym_bucket.h"
+
+#include "transition_relations/disjunctive_transition_relation.h"
+#include "transition_relations/transition_relation.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace symbolic {
+/*
+ * Schedule for the partitioned image computation.
+ * Disjunctive transition relations of the same cost that change the same
+ * variables are grouped. The relational products of a group are disjoined
+ * before the variables are renamed once for the whole group (in the preimage,
+ * the input is renamed once for the whole group). Groups are ordered by the
+ * variables they change, so that consecutive partial images are similar, and
+ * all partial images of one cost are disjoined on the fly in a balanced tree.
+ */
+class ImageSchedule {
+    struct TransitionGroup {
+        BDD exists_vars, exists_bw_vars;
+        std::vector<BDD> swap_vars, swap_vars_p;
+        std::vector<unsigned int> swap_indices; // Sorted indices of swap_vars
+        std::vector<std::shared_ptr<DisjunctiveTransitionRelation>> transitions;
+
+        bool matches(const DisjunctiveTransitionRelation &tr) const;
+    };
+
+    std::map<int, std::vector<TransitionGroup>> groups;
+    // Transition relations that are not grouped (e.g., conjunctive ones)
+    std::map<int, std::vector<TransitionRelationPtr>> ungrouped_transitions;
+
+    void add_transition(
+        int cost, const std::shared_ptr<DisjunctiveTransitionRelation> &tr);
+
+    void group_image(
+        const TransitionGroup &group, const BDD &from, Bucket &res,
+        int max_nodes) const;
+    void group_preimage(
+        const TransitionGroup &group, const BDD &from, Bucket &res,
+        int max_nodes) const;
+
+public:
+    ImageSchedule() = default;
+
+    void init(const std::map<int, std::vector<TransitionRelationPtr>> &trs);
+
+    // Appends the (pre)image of from wrt. all transitions of the given cost.
+    // May throw BDDError if the time or node limit is exceeded.
+    void image(
+        bool fw, int cost, const BDD &from, Bucket &res, int max_nodes) const;
+
+    bool empty() const {
+        return groups.empty() && ungrouped_transitions.empty();
+    }
+
+    int num_groups() const;
+};
+}
+
+#endif
@@ -1,46 +1,95 @@
 #include "open_list.h"
 
 #include "frontier.h"
+#include "sym_state_space_manager.h"
 
 #include <cassert>
 
 using namespace std;
 
 namespace symbolic {
+OpenList::OpenList()
+    : mgr(nullptr),
+      merge_nodes(0),
+      use_add(false),
+      min_open_g(numeric_limits<int>::max()) {
+}
+
+void OpenList::init(SymStateSpaceManager *manager, bool add, int max_nodes) {
+    mgr = manager;
+    use_add = add;
+    merge_nodes = max_nodes;
+    map<int, BalancedOr>().swap(open);
+    min_open_g = numeric_limits<int>::max();
+    if (use_add) {
+        open_costs = mgr->constant(numeric_limits<double>::infinity());
+    }
+}
+
 void OpenList::insert(const Bucket &bucket, int g) {
     assert(!bucket.empty());
-    copy_bucket(bucket, open[g]);
+    for (const BDD &bdd : bucket) {
+        insert(bdd, g);
+    }
 }
 
 void OpenList::insert(const BDD &bdd, int g) {
     assert(!bdd.IsZero());
-    open[g].push_back(bdd);
+    if (use_add) {
+        ADD infinity = mgr->constant(numeric_limits<double>::infinity());
+        open_costs =
+            open_costs.Minimum(bdd.Add().Ite(mgr->constant(g), infinity));
+        min_open_g = min(min_open_g, g);
+        return;
+    }
+    open.try_emplace(g, merge_nodes, merge_nodes > 0)
+        .first->second.insert(bdd);
 }
 
 int OpenList::minNextG(const Frontier &frontier, int min_action_cost) const {
     int next_g =
         (frontier.empty() ? numeric_limits<int>::max()
                           : frontier.g() + min_action_cost);
-    if (!open.empty()) {
-        return min(next_g, open.begin()->first);
-    }
-    return next_g;
+    return min(next_g, minG());
 }
 
 void OpenList::pop(Frontier &frontier) {
     assert(frontier.empty());
+    if (use_add) {
+        ADD infinity = mgr->constant(numeric_limits<double>::infinity());
+        int g = min_open_g;
+        BDD states = open_costs.BddInterval(g, g);
+        open_costs = states.Add().Ite(infinity, open_costs);
+        double next_g = Cudd_V(open_costs.FindMin().getNode());
+        min_open_g = next_g == numeric_limits<double>::infinity()
+                         ? numeric_limits<int>::max()
+                         : static_cast<int>(next_g);
+        Bucket bucket{states};
+        frontier.set(g, bucket);
+        return;
+    }
     int g = open.begin()->first;
-    frontier.set(g, open.begin()->second);
+    Bucket bucket;
+    open.begin()->second.extract(bucket);
+    frontier.set(g, bucket);
     open.erase(g);
 }
 
 int OpenList::minG() const {
+    if (use_add) {
+        return min_open_g;
+    }
     return open.empty() ? numeric_limits<int>::max() : open.begin()->first;
 }
 
 bool OpenList::contains_any_state(const BDD &bdd) const {
+    if (use_add) {
+        BDD open_states =
+            open_costs.BddInterval(0, numeric_limits<double>::max());
+        return !(bdd * open_states).IsZero();
+    }
     for (auto &key : open) {
-        if (bucket_contains_any_state(key.second, bdd)) {
+        if (key.second.contains_any_state(bdd)) {
             return true;
         }
     }
@@ -48,6 +97,9 @@ bool OpenList::contains_any_state(const BDD &bdd) const {
 }
 
 ostream &operator<<(ostream &os, const OpenList &exp) {
+    if (exp.use_add) {
+        return os << " open{add min=" << exp.min_open_g << "}";
+    }
     os << " open{";
     for (auto &o : exp.open) {
         os << o.first << " ";
@@ -2,9 +2,11 @@
 #define SYMBOLIC_OPEN_LIST_H
 
 #include "sym_bucket.h"
+#include "sym_utils.h"
 
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <map>
 
 namespace symbolic {
@@ -12,7 +14,20 @@ class SymStateSpaceManager;
 class Frontier;
 
 class OpenList {
-    std::map<int, Bucket> open; // States in open with unkwown h-value
+    SymStateSpaceManager *mgr;
+    // States in open with unkwown h-value. With merge_nodes > 0, the BDDs of
+    // each bucket are disjoined when they are inserted, as long as the
+    // results stay below merge_nodes.
+    std::map<int, BalancedOr> open;
+    int merge_nodes;
+
+    // Alternatively, all states in open are represented by a single ADD that
+    // maps each state to its minimum g value (and infinity if it is not in
+    // open). Only states with minimum g are kept, so this requires that each
+    // state is expanded only once.
+    bool use_add;
+    ADD open_costs;
+    int min_open_g; // Minimum value of open_costs (or max int if empty)
 
     // At any point in the search we can close all the states in
     // open[minG()] because they cannot be generated with lower
@@ -20,7 +35,14 @@ class OpenList {
     void closeMinOpen();
 
 public:
+    OpenList();
+
+    void init(SymStateSpaceManager *mgr, bool use_add, int merge_nodes = 0);
+
     bool empty() const {
+        if (use_add) {
+            return min_open_g == std::numeric_limits<int>::max();
+        }
         assert(open.empty() || !open.begin()->second.empty());
         return open.empty();
     }
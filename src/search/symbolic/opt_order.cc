@@ -7,15 +7,25 @@
 #include "../utils/logging.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <ostream>
+#include <thread>
 
 using namespace std;
 
 namespace symbolic {
+// Random restarts after optimizing the initial order and the maximum time
+// (seconds) after which no further restart is started
+static const int NUM_RESTARTS = 20;
+static const double MAX_RESTART_TIME = 30.0;
+static const int NUM_ITERATIONS = 50000;
+
 // Returns a optimized variable ordering that reorders the variables
 // according to the standard causal graph criterion
 void InfluenceGraph::compute_gamer_ordering(
-    vector<int> &var_order, const shared_ptr<AbstractTask> &task) {
+    vector<int> &var_order, const shared_ptr<AbstractTask> &task,
+    int num_threads) {
     TaskProxy task_proxy(*task);
 
     const causal_graph::CausalGraph &cg = task_proxy.get_causal_graph();
@@ -35,80 +45,121 @@ void InfluenceGraph::compute_gamer_ordering(
         }
     }
 
-    ig_partitions.get_ordering(var_order);
+    ig_partitions.get_ordering(var_order, num_threads);
+}
+
+void InfluenceGraph::set_influence(int v1, int v2, double val) {
+    if (val == 0) {
+        return;
+    }
+    for (auto [from, to] : {make_pair(v1, v2), make_pair(v2, v1)}) {
+        vector<int> &adjacent = neighbours[from];
+        auto it = lower_bound(adjacent.begin(), adjacent.end(), to);
+        if (it == adjacent.end() || *it != to) {
+            adjacent.insert(it, to);
+        }
+    }
 }
 
-void InfluenceGraph::get_ordering(vector<int> &ordering) const {
+/*
+ * Restart 0 optimizes the given order, restart i > 0 a random permutation.
+ * Restarts are distributed among the threads and each one uses its own random
+ * number generator (seeded with its index), so the result does not depend on
+ * the number of threads unless the time runs out.
+ */
+void InfluenceGraph::get_ordering(
+    vector<int> &ordering, int num_threads) const {
     utils::g_log << "Optimizing variable ordering..." << flush;
     utils::Timer timer;
-    double value_optimization_function =
-        optimize_variable_ordering_gamer(ordering, 50000);
 
-    for (int counter = 0; counter < 20; counter++) {
-        if (timer() > 30.0) {
-            utils::g_log << "Timeout: exceeded 30 seconds! " << endl;
-            break;
+    int num_runs = NUM_RESTARTS + 1;
+    vector<vector<int>> orders(num_runs);
+    vector<double> values(num_runs, -1);
+    atomic<int> next_run(0);
+    auto worker = [&]() {
+        for (int run = next_run++; run < num_runs; run = next_run++) {
+            if (run > 0 && timer() > MAX_RESTART_TIME) {
+                break;
+            }
+            utils::RandomNumberGenerator rng(run);
+            orders[run] = ordering;
+            if (run > 0) {
+                rng.shuffle(orders[run]);
+            }
+            values[run] = optimize_variable_ordering_gamer(
+                orders[run], NUM_ITERATIONS, rng);
         }
-        vector<int> new_order = randomize(ordering); // Copy the order randomly
-        double new_value = optimize_variable_ordering_gamer(new_order, 50000);
+    };
 
-        if (new_value < value_optimization_function) {
-            value_optimization_function = new_value;
-            ordering.swap(new_order);
+    num_threads = max(1, min(num_threads, num_runs));
+    vector<thread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    int best = 0;
+    for (int run = 1; run < num_runs; ++run) {
+        if (values[run] >= 0 && values[run] < values[best]) {
+            best = run;
         }
     }
+    if (count(values.begin(), values.end(), -1) > 0) {
+        utils::g_log << "Timeout: exceeded " << MAX_RESTART_TIME
+                     << " seconds! ";
+    }
+    ordering.swap(orders[best]);
     utils::g_log << "done!" << " [t=" << timer << "]" << endl;
 }
 
-vector<int> InfluenceGraph::randomize(const vector<int> &ordering) const {
-    vector<int> new_order = ordering;
-    rng->shuffle(new_order);
-    return new_order;
+double InfluenceGraph::swap_delta(
+    const vector<int> &order, const vector<int> &position, int pos1,
+    int pos2) const {
+    double delta = 0;
+    int var1 = order[pos1];
+    int var2 = order[pos2];
+    for (int v : neighbours[var1]) {
+        if (v != var2) {
+            int i = position[v];
+            delta += -(i - pos1) * (i - pos1) + (i - pos2) * (i - pos2);
+        }
+    }
+    for (int v : neighbours[var2]) {
+        if (v != var1) {
+            int i = position[v];
+            delta += -(i - pos2) * (i - pos2) + (i - pos1) * (i - pos1);
+        }
+    }
+    return delta;
 }
 
 double InfluenceGraph::optimize_variable_ordering_gamer(
-    vector<int> &order, int iterations) const {
+    vector<int> &order, int iterations,
+    utils::RandomNumberGenerator &rng) const {
     double totalDistance = compute_function(order);
+    vector<int> position(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
 
-    double oldTotalDistance = totalDistance;
     // Repeat iterations times
     for (int counter = 0; counter < iterations; counter++) {
         // Swap variable
-        int swapIndex1 = rng->random(order.size());
-        int swapIndex2 = rng->random(order.size());
+        int swapIndex1 = rng.random(order.size());
+        int swapIndex2 = rng.random(order.size());
         if (swapIndex1 == swapIndex2)
             continue;
 
-        // Compute the new value of the optimization function
-        for (int i = 0; i < int(order.size()); i++) {
-            if ((int)i == swapIndex1 || (int)i == swapIndex2)
-                continue;
-
-            if (influence(order[i], order[swapIndex1]))
-                totalDistance +=
-                    (-(i - swapIndex1) * (i - swapIndex1) +
-                     (i - swapIndex2) * (i - swapIndex2));
-
-            if (influence(order[i], order[swapIndex2]))
-                totalDistance +=
-                    (-(i - swapIndex2) * (i - swapIndex2) +
-                     (i - swapIndex1) * (i - swapIndex1));
-        }
-
         // Apply the swap if it is worthy
-        if (totalDistance < oldTotalDistance) {
-            int tmp = order[swapIndex1];
-            order[swapIndex1] = order[swapIndex2];
-            order[swapIndex2] = tmp;
-            oldTotalDistance = totalDistance;
-
-            /*if(totalDistance != compute_function(order)){
-              cerr << "Error computing total distance: " << totalDistance << " "
-            << compute_function(order) << endl; exit(-1); }else{ utils::g_log <<
-            "Bien: " << totalDistance << endl;
-            }*/
-        } else {
-            totalDistance = oldTotalDistance;
+        double delta = swap_delta(order, position, swapIndex1, swapIndex2);
+        if (delta < 0) {
+            swap(order[swapIndex1], order[swapIndex2]);
+            position[order[swapIndex1]] = swapIndex1;
+            position[order[swapIndex2]] = swapIndex2;
+            totalDistance += delta;
         }
     }
     //  utils::g_log << "Total distance: " << totalDistance << endl;
@@ -116,77 +167,54 @@ double InfluenceGraph::optimize_variable_ordering_gamer(
 }
 
 double InfluenceGraph::compute_function(const vector<int> &order) const {
+    vector<int> position(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
     double totalDistance = 0;
-    for (size_t i = 0; i < order.size() - 1; i++) {
-        for (size_t j = i + 1; j < order.size(); j++) {
-            if (influence(order[i], order[j])) {
-                totalDistance += (j - i) * (j - i);
+    for (size_t v = 0; v < neighbours.size(); ++v) {
+        for (int v2 : neighbours[v]) {
+            if (v2 > static_cast<int>(v)) {
+                double distance = position[v] - position[v2];
+                totalDistance += distance * distance;
             }
         }
     }
     return totalDistance;
 }
 
-InfluenceGraph::InfluenceGraph(int num) {
-    // TODO(speckd): we need to randomize the seed here
-    rng = make_shared<utils::RandomNumberGenerator>(0);
-    influence_graph.resize(num);
-    for (auto &i : influence_graph) {
-        i.resize(num, 0);
-    }
+InfluenceGraph::InfluenceGraph(int num) : neighbours(num) {
 }
 
 void InfluenceGraph::optimize_variable_ordering_gamer(
     vector<int> &order, vector<int> &partition_begin,
     vector<int> &partition_sizes, int iterations) const {
-    double totalDistance = compute_function(order);
+    // TODO(speckd): we need to randomize the seed here
+    utils::RandomNumberGenerator rng(0);
+    vector<int> position(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = i;
+    }
 
-    double oldTotalDistance = totalDistance;
     // Repeat iterations times
     for (int counter = 0; counter < iterations; counter++) {
         // Swap variable
-        int partition = rng->random(partition_begin.size());
+        int partition = rng.random(partition_begin.size());
         if (partition_sizes[partition] <= 1)
             continue;
         int swapIndex1 = partition_begin[partition] +
-                         rng->random(partition_sizes[partition]);
+                         rng.random(partition_sizes[partition]);
         int swapIndex2 = partition_begin[partition] +
-                         rng->random(partition_sizes[partition]);
+                         rng.random(partition_sizes[partition]);
         if (swapIndex1 == swapIndex2)
             continue;
 
-        // Compute the new value of the optimization function
-        for (int i = 0; i < int(order.size()); i++) {
-            if ((int)i == swapIndex1 || (int)i == swapIndex2)
-                continue;
-
-            if (influence(order[i], order[swapIndex1]))
-                totalDistance +=
-                    (-(i - swapIndex1) * (i - swapIndex1) +
-                     (i - swapIndex2) * (i - swapIndex2));
-
-            if (influence(order[i], order[swapIndex2]))
-                totalDistance +=
-                    (-(i - swapIndex2) * (i - swapIndex2) +
-                     (i - swapIndex1) * (i - swapIndex1));
-        }
-
         // Apply the swap if it is worthy
-        if (totalDistance < oldTotalDistance) {
-            int tmp = order[swapIndex1];
-            order[swapIndex1] = order[swapIndex2];
-            order[swapIndex2] = tmp;
-            oldTotalDistance = totalDistance;
-
-            /*if(totalDistance != compute_function(order)){
-              cerr << "Error computing total distance: " << totalDistance << " "
-            << compute_function(order) << endl; exit(-1); }else{ utils::g_log <<
-            "Bien: " << totalDistance << endl;
-            }*/
-        } else {
-            totalDistance = oldTotalDistance;
+        if (swap_delta(order, position, swapIndex1, swapIndex2) < 0) {
+            swap(order[swapIndex1], order[swapIndex2]);
+            position[order[swapIndex1]] = swapIndex1;
+            position[order[swapIndex2]] = swapIndex2;
         }
     }
-    //  utils::g_log << "Total distance: " << totalDistance << endl;
 }
 } // namespace symbolic
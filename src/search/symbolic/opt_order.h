@@ -9,34 +9,41 @@
 class AbstractTask;
 
 namespace symbolic {
+/*
+ * Undirected graph of variables that influence each other. The Gamer
+ * ordering minimizes the sum of squared distances of influencing variables
+ * by random swaps. The graph is stored as sorted adjacency lists, so that
+ * the change of the objective function by a swap is computed in time linear
+ * in the degree of the two swapped variables.
+ */
 class InfluenceGraph {
-    std::vector<std::vector<double>> influence_graph;
-    std::shared_ptr<utils::RandomNumberGenerator> rng;
+    std::vector<std::vector<int>> neighbours;
 
-    double influence(int v1, int v2) const {
-        return influence_graph[v1][v2];
-    }
+    // Change of the objective if the variables at positions pos1 and pos2
+    // are swapped (position[v] is the position of v in the order).
+    double swap_delta(
+        const std::vector<int> &order, const std::vector<int> &position,
+        int pos1, int pos2) const;
 
     double optimize_variable_ordering_gamer(
-        std::vector<int> &order, int iterations) const;
+        std::vector<int> &order, int iterations,
+        utils::RandomNumberGenerator &rng) const;
     double compute_function(const std::vector<int> &order) const;
-    void optimize_ordering_gamer(std::vector<int> &ordering) const;
-    std::vector<int> randomize(const std::vector<int> &ordering) const;
 
 public:
     InfluenceGraph(int num);
-    void get_ordering(std::vector<int> &ordering) const;
+    void get_ordering(std::vector<int> &ordering, int num_threads = 1) const;
     void optimize_variable_ordering_gamer(
         std::vector<int> &order, std::vector<int> &partition_begin,
         std::vector<int> &partition_sizes, int iterations = 50000) const;
 
-    void set_influence(int v1, int v2, double val = 1) {
-        influence_graph[v1][v2] = val;
-        influence_graph[v2][v1] = val;
-    }
+    // Only whether two variables influence each other matters; any non-zero
+    // value adds the edge.
+    void set_influence(int v1, int v2, double val = 1);
 
     static void compute_gamer_ordering(
-        std::vector<int> &ordering, const std::shared_ptr<AbstractTask> &task);
+        std::vector<int> &ordering, const std::shared_ptr<AbstractTask> &task,
+        int num_threads = 1);
 };
 }
 
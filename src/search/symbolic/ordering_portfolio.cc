@@ -0,0 +1,240 @@
+#include "ordering_portfolio.h"
+
+#include "opt_order.h"
+#include "sym_variables.h"
+
+#include "../task_utils/variable_order_finder.h"
+#include "../utils/logging.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+
+using namespace std;
+
+namespace symbolic {
+vector<int> compute_force_ordering(
+    const TaskProxy &task_proxy, const vector<int> &initial_order,
+    int iterations) {
+    int num_vars = task_proxy.get_variables().size();
+    // Hyperedges: the variables mentioned by each operator
+    vector<vector<int>> edges;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        set<int> vars;
+        for (FactProxy pre : op.get_preconditions()) {
+            vars.insert(pre.get_variable().get_id());
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            vars.insert(eff.get_fact().get_variable().get_id());
+        }
+        if (vars.size() > 1) {
+            edges.emplace_back(vars.begin(), vars.end());
+        }
+    }
+
+    vector<int> order = initial_order;
+    vector<double> position(num_vars);
+    auto compute_span = [&]() {
+        double span = 0;
+        for (const vector<int> &edge : edges) {
+            auto [min_it, max_it] = minmax_element(
+                edge.begin(), edge.end(), [&position](int v1, int v2) {
+                    return position[v1] < position[v2];
+                });
+            span += position[*max_it] - position[*min_it];
+        }
+        return span;
+    };
+    for (int i = 0; i < num_vars; ++i) {
+        position[order[i]] = i;
+    }
+    double best_span = compute_span();
+    vector<int> best_order = order;
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        vector<double> sum(num_vars, 0);
+        vector<int> degree(num_vars, 0);
+        for (const vector<int> &edge : edges) {
+            double center = 0;
+            for (int var : edge) {
+                center += position[var];
+            }
+            center /= edge.size();
+            for (int var : edge) {
+                sum[var] += center;
+                ++degree[var];
+            }
+        }
+        for (int var = 0; var < num_vars; ++var) {
+            if (degree[var] > 0) {
+                position[var] = sum[var] / degree[var];
+            }
+        }
+        stable_sort(order.begin(), order.end(), [&position](int v1, int v2) {
+            return position[v1] < position[v2];
+        });
+        for (int i = 0; i < num_vars; ++i) {
+            position[order[i]] = i;
+        }
+
+        double span = compute_span();
+        if (span >= best_span) {
+            break;
+        }
+        best_span = span;
+        best_order = order;
+    }
+    return best_order;
+}
+
+OrderingPortfolio::OrderingPortfolio(
+    const shared_ptr<AbstractTask> &task, int probe_layers, int probe_time,
+    int gamer_threads)
+    : task(task),
+      task_proxy(*task),
+      probe_layers(probe_layers),
+      probe_time(probe_time),
+      gamer_threads(gamer_threads) {
+}
+
+void OrderingPortfolio::add_candidate(
+    const string &name, const vector<int> &order) {
+    for (const Candidate &candidate : candidates) {
+        if (candidate.order == order) {
+            return;
+        }
+    }
+    candidates.push_back({name, order});
+}
+
+double OrderingPortfolio::probe(const vector<int> &order, int max_time) const {
+    int num_vars = task_proxy.get_variables().size();
+    vector<vector<int>> pre_index(num_vars), eff_index(num_vars);
+    int num_bdd_vars = 0;
+    for (int var : order) {
+        int var_len = static_cast<int>(
+            ceil(log2(task_proxy.get_variables()[var].get_domain_size())));
+        for (int j = 0; j < var_len; ++j) {
+            pre_index[var].push_back(num_bdd_vars);
+            eff_index[var].push_back(num_bdd_vars + 1);
+            num_bdd_vars += 2;
+        }
+    }
+
+    Cudd manager(num_bdd_vars, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
+    manager.setHandler(exceptionError);
+    manager.setTimeoutHandler(exceptionError);
+    manager.setNodesExceededHandler(exceptionError);
+    manager.SetTimeLimit(max_time);
+    manager.ResetStartTime();
+
+    auto fact_bdd = [&manager](const vector<int> &indices, int value) {
+        BDD res = manager.bddOne();
+        for (size_t j = 0; j < indices.size(); ++j) {
+            BDD bit = manager.bddVar(indices[j]);
+            res *= ((value >> j) & 1) ? bit : !bit;
+        }
+        return res;
+    };
+
+    struct ProbeTransition {
+        BDD tr;
+        BDD exists_vars;
+        vector<BDD> swap_vars, swap_vars_p;
+    };
+
+    try {
+        double nodes = 0;
+        vector<ProbeTransition> transitions;
+        for (OperatorProxy op : task_proxy.get_operators()) {
+            ProbeTransition t{manager.bddOne(), manager.bddOne(), {}, {}};
+            for (FactProxy pre : op.get_preconditions()) {
+                int var = pre.get_variable().get_id();
+                if (!pre.get_variable().is_derived()) {
+                    t.tr *= fact_bdd(pre_index[var], pre.get_value());
+                }
+            }
+            for (EffectProxy eff : op.get_effects()) {
+                if (!eff.get_conditions().empty()) {
+                    continue;
+                }
+                int var = eff.get_fact().get_variable().get_id();
+                t.tr *= fact_bdd(eff_index[var], eff.get_fact().get_value());
+                for (size_t j = 0; j < pre_index[var].size(); ++j) {
+                    t.exists_vars *= manager.bddVar(pre_index[var][j]);
+                    t.swap_vars.push_back(manager.bddVar(pre_index[var][j]));
+                    t.swap_vars_p.push_back(manager.bddVar(eff_index[var][j]));
+                }
+            }
+            nodes += t.tr.nodeCount();
+            transitions.push_back(move(t));
+        }
+
+        vector<int> init_values = task->get_initial_state_values();
+        BDD reached = manager.bddOne();
+        for (int var = 0; var < num_vars; ++var) {
+            reached *= fact_bdd(pre_index[var], init_values[var]);
+        }
+        BDD layer = reached;
+        for (int i = 0; i < probe_layers && !layer.IsZero(); ++i) {
+            BDD next = manager.bddZero();
+            for (const ProbeTransition &t : transitions) {
+                next += t.tr.AndAbstract(layer, t.exists_vars)
+                            .SwapVariables(t.swap_vars, t.swap_vars_p);
+            }
+            layer = next * !reached;
+            reached += next;
+            nodes += reached.nodeCount();
+        }
+        return nodes;
+    } catch (const BDDError &e) {
+        return numeric_limits<double>::infinity();
+    }
+}
+
+vector<int> OrderingPortfolio::compute_ordering() {
+    utils::Timer timer;
+    vector<int> gamer_order;
+    InfluenceGraph::compute_gamer_ordering(gamer_order, task, gamer_threads);
+    add_candidate("gamer", gamer_order);
+    add_candidate(
+        "reverse_gamer", vector<int>(gamer_order.rbegin(), gamer_order.rend()));
+    add_candidate("force", compute_force_ordering(task_proxy, gamer_order));
+    vector<pair<string, variable_order_finder::VariableOrderType>> fd_orders =
+        {{"level", variable_order_finder::LEVEL},
+         {"reverse_level", variable_order_finder::REVERSE_LEVEL},
+         {"cg_goal_level", variable_order_finder::CG_GOAL_LEVEL},
+         {"goal_cg_level", variable_order_finder::GOAL_CG_LEVEL}};
+    for (const auto &[name, type] : fd_orders) {
+        variable_order_finder::VariableOrderFinder finder(task_proxy, type);
+        vector<int> order;
+        while (!finder.done()) {
+            order.push_back(finder.next());
+        }
+        add_candidate(name, order);
+    }
+
+    int max_time = max(1, probe_time / static_cast<int>(candidates.size()));
+    size_t best = 0;
+    double best_nodes = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        double nodes = probe(candidates[i].order, max_time);
+        utils::g_log << "Ordering probe " << candidates[i].name << ": ";
+        if (nodes == numeric_limits<double>::infinity()) {
+            utils::g_log << "timeout" << endl;
+        } else {
+            utils::g_log << nodes << " nodes" << endl;
+        }
+        if (nodes < best_nodes) {
+            best_nodes = nodes;
+            best = i;
+        }
+    }
+    utils::g_log << "Selected variable ordering: " << candidates[best].name
+                 << " [t=" << timer << "]" << endl;
+    return candidates[best].order;
+}
+}
@@ -0,0 +1,56 @@
+#ifndef SYMBOLIC_ORDERING_PORTFOLIO_H
+#define SYMBOLIC_ORDERING_PORTFOLIO_H
+
+#include "../task_proxy.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class AbstractTask;
+
+namespace symbolic {
+/*
+ * Portfolio of static variable orderings. Several candidate orders are
+ * computed (Gamer, reverse Gamer, FORCE and the orders of the
+ * variable_order_finder) and each one is probed in a separate, temporary
+ * CUDD manager: we build one transition relation per operator and compute
+ * the first BFS layers from the initial state. The order with the smallest
+ * sum of TR nodes and nodes of the reached states is selected. The probe is
+ * an approximation: conditional effects and conditions on derived variables
+ * are ignored.
+ */
+class OrderingPortfolio {
+    struct Candidate {
+        std::string name;
+        std::vector<int> order;
+    };
+
+    std::shared_ptr<AbstractTask> task;
+    TaskProxy task_proxy;
+    const int probe_layers;
+    const int probe_time; // Total time (ms) for probing all candidates
+    const int gamer_threads;
+    std::vector<Candidate> candidates;
+
+    void add_candidate(const std::string &name, const std::vector<int> &order);
+
+    // Returns the number of nodes of the probe or infinity if it timed out.
+    double probe(const std::vector<int> &order, int max_time) const;
+
+public:
+    OrderingPortfolio(
+        const std::shared_ptr<AbstractTask> &task, int probe_layers,
+        int probe_time, int gamer_threads = 1);
+
+    std::vector<int> compute_ordering();
+};
+
+// Iteratively moves each variable to the center of gravity of the operators
+// that mention it (FORCE heuristic), starting from the given order.
+extern std::vector<int> compute_force_ordering(
+    const TaskProxy &task_proxy, const std::vector<int> &initial_order,
+    int iterations = 20);
+}
+
+#endif
@@ -0,0 +1,191 @@
+#include "parallel_image.h"
+
+#include "sym_utils.h"
+#include "sym_variables.h"
+
+#include "transition_relations/disjunctive_transition_relation.h"
+
+#include "../utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+using namespace std;
+
+namespace symbolic {
+ParallelImage::ParallelImage(
+    SymVariables *sym_vars, const map<int, vector<TransitionRelationPtr>> &trs,
+    int num_threads)
+    : sym_vars(sym_vars) {
+    assert(num_threads > 1);
+    vector<pair<int, shared_ptr<DisjunctiveTransitionRelation>>> disj_trs;
+    for (const auto &[cost, tr_vec] : trs) {
+        for (const TransitionRelationPtr &tr : tr_vec) {
+            auto disj_tr =
+                dynamic_pointer_cast<DisjunctiveTransitionRelation>(tr);
+            if (disj_tr) {
+                disj_trs.emplace_back(cost, disj_tr);
+            } else {
+                main_transitions[cost].push_back(tr);
+            }
+        }
+    }
+
+    int num_workers = min<int>(num_threads, disj_trs.size());
+    workers.resize(num_workers);
+    for (Worker &worker : workers) {
+        worker.manager = sym_vars->create_worker_manager(num_workers);
+        worker.failed = false;
+    }
+    for (int var = 0; var < sym_vars->get_manager()->ReadSize(); ++var) {
+        worker_order.push_back(var);
+    }
+    sync_variable_order();
+
+    // Greedy load balancing: largest transition relations first, each to the
+    // worker with the least nodes so far
+    sort(disj_trs.begin(), disj_trs.end(), [](const auto &a, const auto &b) {
+        return a.second->nodeCount() > b.second->nodeCount();
+    });
+    vector<long> worker_nodes(num_workers, 0);
+    for (const auto &[cost, tr] : disj_trs) {
+        int w = min_element(worker_nodes.begin(), worker_nodes.end()) -
+                worker_nodes.begin();
+        worker_nodes[w] += tr->nodeCount();
+        Cudd &worker_manager = *workers[w].manager;
+
+        WorkerTransition worker_tr;
+        worker_tr.cost = cost;
+        worker_tr.tr_bdd = tr->get_tr_BDD().Transfer(worker_manager);
+        worker_tr.exists_vars = tr->get_exists_vars().Transfer(worker_manager);
+        worker_tr.exists_bw_vars =
+            tr->get_exists_bw_vars().Transfer(worker_manager);
+        for (const BDD &var : tr->get_swap_vars()) {
+            worker_tr.swap_vars.push_back(var.Transfer(worker_manager));
+        }
+        for (const BDD &var : tr->get_swap_vars_p()) {
+            worker_tr.swap_vars_p.push_back(var.Transfer(worker_manager));
+        }
+        workers[w].transitions.push_back(move(worker_tr));
+    }
+
+    utils::g_log << "Parallel image: " << num_workers << " workers with "
+                 << disj_trs.size() << " transition relations" << endl;
+}
+
+void ParallelImage::sync_variable_order() {
+    Cudd *manager = sym_vars->get_manager();
+    vector<int> order(manager->ReadSize());
+    for (size_t level = 0; level < order.size(); ++level) {
+        order[level] = manager->ReadInvPerm(level);
+    }
+    if (order == worker_order) {
+        return;
+    }
+    for (Worker &worker : workers) {
+        worker.manager->ShuffleHeap(order.data());
+    }
+    worker_order = move(order);
+}
+
+void ParallelImage::worker_image(
+    Worker &worker, bool fw, bool zero_cost, const BDD &from,
+    unsigned long max_time, int max_nodes) {
+    if (max_time > 0) {
+        worker.manager->SetTimeLimit(max_time);
+        worker.manager->ResetStartTime();
+    }
+    try {
+        map<int, BalancedOr> cost_res;
+        for (const WorkerTransition &tr : worker.transitions) {
+            if ((tr.cost == 0) != zero_cost) {
+                continue;
+            }
+            BDD res;
+            if (fw) {
+                res = tr.tr_bdd.AndAbstract(from, tr.exists_vars, max_nodes);
+                res = res.SwapVariables(tr.swap_vars, tr.swap_vars_p);
+            } else {
+                res = from.SwapVariables(tr.swap_vars, tr.swap_vars_p);
+                res = tr.tr_bdd.AndAbstract(res, tr.exists_bw_vars, max_nodes);
+            }
+            cost_res.try_emplace(tr.cost, max_nodes).first->second.insert(res);
+        }
+        for (auto &[cost, balanced_or] : cost_res) {
+            balanced_or.extract(worker.result[cost]);
+        }
+    } catch (const BDDError &e) {
+        worker.failed = true;
+    }
+    worker.manager->UnsetTimeLimit();
+}
+
+void ParallelImage::image(
+    bool fw, bool zero_cost, const BDD &from, map<int, Bucket> &res,
+    int max_nodes) {
+    sync_variable_order();
+    unsigned long max_time = sym_vars->get_remaining_time();
+
+    vector<BDD> worker_from;
+    worker_from.reserve(workers.size());
+    for (Worker &worker : workers) {
+        worker_from.push_back(from.Transfer(*worker.manager));
+        worker.failed = false;
+    }
+
+    vector<thread> threads;
+    threads.reserve(workers.size());
+    for (size_t w = 0; w < workers.size(); ++w) {
+        threads.emplace_back(
+            worker_image, ref(workers[w]), fw, zero_cost, cref(worker_from[w]),
+            max_time, max_nodes);
+    }
+
+    // Meanwhile, the remaining transition relations are applied here.
+    bool failed = false;
+    try {
+        for (const auto &[cost, tr_vec] : main_transitions) {
+            if ((cost == 0) != zero_cost) {
+                continue;
+            }
+            for (const TransitionRelationPtr &tr : tr_vec) {
+                res[cost].push_back(
+                    fw ? tr->image(from, max_nodes)
+                       : tr->preimage(from, max_nodes));
+            }
+        }
+    } catch (const BDDError &e) {
+        failed = true;
+    }
+
+    for (thread &t : threads) {
+        t.join();
+    }
+    worker_from.clear();
+
+    for (const Worker &worker : workers) {
+        failed |= worker.failed;
+    }
+    if (!failed) {
+        try {
+            for (const Worker &worker : workers) {
+                for (const auto &[cost, bucket] : worker.result) {
+                    for (const BDD &bdd : bucket) {
+                        res[cost].push_back(sym_vars->transfer(bdd));
+                    }
+                }
+            }
+        } catch (const BDDError &e) {
+            failed = true;
+        }
+    }
+    for (Worker &worker : workers) {
+        worker.result.clear();
+    }
+
+    if (failed) {
+        throw BDDError();
+    }
+}
+}
@@ -0,0 +1,75 @@
+#ifndef SYMBOLIC_PARALLEL_IMAGE_H
+#define SYMBOLIC_PARALLEL_IMAGE_H
+
+#include "sym_bucket.h"
+
+#include "transition_relations/transition_relation.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace symbolic {
+class SymVariables;
+
+/*
+ * Computes images with several threads. CUDD managers are not thread-safe,
+ * so each worker thread owns a separate manager with the same variables.
+ * The disjunctive transition relations are distributed among the workers
+ * (balanced by their node count) and copied into the worker managers once.
+ * For each image, the input BDD is transferred to all workers, each worker
+ * computes and disjoins the images of its transition relations, and the
+ * results are transferred back to the main manager. Conjunctive transition
+ * relations are applied by the calling thread in the meantime. The workers
+ * follow the variable order of the main manager, so that the transfers do
+ * not need to reorder the BDDs.
+ */
+class ParallelImage {
+    struct WorkerTransition {
+        int cost;
+        BDD tr_bdd;
+        BDD exists_vars, exists_bw_vars;
+        std::vector<BDD> swap_vars, swap_vars_p;
+    };
+
+    struct Worker {
+        // The manager must outlive all BDDs of the worker.
+        std::shared_ptr<Cudd> manager;
+        std::vector<WorkerTransition> transitions;
+        std::map<int, Bucket> result;
+        bool failed;
+    };
+
+    SymVariables *sym_vars;
+    std::vector<Worker> workers;
+    std::map<int, std::vector<TransitionRelationPtr>> main_transitions;
+    // Variable index at each level in the worker managers
+    std::vector<int> worker_order;
+
+    // Applies the variable order of the main manager to the workers if it
+    // has been reordered since the last call
+    void sync_variable_order();
+
+    static void worker_image(
+        Worker &worker, bool fw, bool zero_cost, const BDD &from,
+        unsigned long max_time, int max_nodes);
+
+public:
+    ParallelImage(
+        SymVariables *sym_vars,
+        const std::map<int, std::vector<TransitionRelationPtr>> &trs,
+        int num_threads);
+
+    ParallelImage(const ParallelImage &) = delete;
+    ParallelImage &operator=(const ParallelImage &) = delete;
+
+    // Computes the (pre)image wrt. all transition relations with zero cost or
+    // with non-zero cost, respectively, and adds the results to res.
+    // Throws BDDError if the time or node limit is exceeded in any thread.
+    void image(
+        bool fw, bool zero_cost, const BDD &from, std::map<int, Bucket> &res,
+        int max_nodes);
+};
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include "../../state_registry.h"
 #include "../../task_utils/task_properties.h"
 
+#include <sstream>
+
 using namespace std;
 
 namespace symbolic {
@@ -13,6 +15,17 @@ void PlanSelector::add_options_to_feature(plugins::Feature &feature) {
     feature.add_option<int>(
         "num_plans", "number of plans", "infinity",
         plugins::Bounds("1", "infinity"));
+    feature.add_option<string>(
+        "plan_stream_file",
+        "write all plans to this file (one after the other) with a background "
+        "thread instead of one file per plan (empty = one file per plan)",
+        "\"\"");
+    feature.add_option<int>(
+        "plan_stream_queue",
+        "maximum number of plans waiting to be written to plan_stream_file "
+        "before the search waits for the writer. Queued plans are lost if "
+        "the planner is killed, e.g., on the time or memory limit",
+        "10", plugins::Bounds("1", "infinity"));
 }
 
 PlanSelector::PlanSelector(const plugins::Options &opts)
@@ -25,7 +38,13 @@ PlanSelector::PlanSelector(const plugins::Options &opts)
       num_accepted_plans(0),
       num_rejected_plans(0),
       plan_mgr_task_proxy(*tasks::g_root_task),
+      unit_cost(task_properties::is_unit_cost(plan_mgr_task_proxy)),
       first_accepted_plan_cost(numeric_limits<double>::infinity()) {
+    string plan_stream_file = opts.get<string>("plan_stream_file");
+    if (write_plans && !plan_stream_file.empty()) {
+        plan_writer = make_unique<PlanWriter>(
+            plan_stream_file, opts.get<int>("plan_stream_queue"));
+    }
 }
 
 void PlanSelector::init(
@@ -65,7 +84,11 @@ const Plan &PlanSelector::get_first_accepted_plan() const {
 
 void PlanSelector::print_options() const {
     utils::g_log << "Plan Selector: " << tag() << endl;
-    utils::g_log << "Plan files: " << plan_mgr.get_plan_filename() << endl;
+    if (plan_writer) {
+        utils::g_log << "Plan stream: " << plan_writer->get_file_name() << endl;
+    } else {
+        utils::g_log << "Plan files: " << plan_mgr.get_plan_filename() << endl;
+    }
 }
 
 size_t PlanSelector::different(
@@ -154,12 +177,30 @@ void PlanSelector::save_accepted_plan(const Plan &plan) {
         }
     }
 
-    if (write_plans) {
+    if (plan_writer) {
+        stream_plan(plan);
+    } else if (write_plans) {
         plan_mgr.save_plan(
             plan, plan_mgr_task_proxy, dump_plans, num_desired_plans > 1);
     }
 }
 
+// Same format as the plan files, with a comment line before each plan
+void PlanSelector::stream_plan(const Plan &plan) {
+    if (dump_plans) {
+        plan_mgr.dump_plan(plan, plan_mgr_task_proxy);
+    }
+    OperatorsProxy operators = plan_mgr_task_proxy.get_operators();
+    ostringstream plan_text;
+    plan_text << "; plan " << num_accepted_plans << "\n";
+    for (OperatorID op_id : plan) {
+        plan_text << "(" << operators[op_id].get_name() << ")\n";
+    }
+    plan_text << "; cost = " << calculate_plan_cost(plan, plan_mgr_task_proxy)
+              << " (" << (unit_cost ? "unit cost" : "general cost") << ")\n";
+    plan_writer->add_plan(plan_text.str());
+}
+
 void PlanSelector::save_rejected_plan(const Plan &plan) {
     size_t plan_seed = get_hash_value(plan);
     if (hashes_rejected_plans.count(plan_seed) == 0) {
@@ -1,6 +1,8 @@
 #ifndef SYMBOLIC_PLAN_SELECTION_H
 #define SYMBOLIC_PLAN_SELECTION_H
 
+#include "plan_writer.h"
+
 #include "../sym_variables.h"
 
 #include "../../plan_manager.h"
@@ -61,7 +63,12 @@ public:
                                    : sym_vars->oneBDD();
     }
 
+    // With a plan stream, waits until the queued plans are written
     int get_num_reported_plan() const {
+        if (plan_writer) {
+            plan_writer->wait_until_written();
+            return plan_writer->get_num_plans();
+        }
         return plan_mgr.get_num_previously_generated_plans();
     }
 
@@ -101,6 +108,9 @@ protected:
 
     TaskProxy plan_mgr_task_proxy;
     PlanManager plan_mgr;
+    // If set, all plans are written to one file by a background thread
+    std::unique_ptr<PlanWriter> plan_writer;
+    bool unit_cost;
 
     std::unordered_map<size_t, std::vector<Plan>> hashes_accepted_plans;
     std::unordered_map<size_t, std::vector<Plan>> hashes_rejected_plans;
@@ -111,6 +121,7 @@ protected:
     BDD states_accepted_goal_paths;
 
     void save_accepted_plan(const Plan &plan);
+    void stream_plan(const Plan &plan);
     void save_rejected_plan(const Plan &plan);
 
     std::vector<Plan> get_accepted_plans() const;
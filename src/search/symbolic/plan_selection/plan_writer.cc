@@ -0,0 +1,77 @@
+#include "plan_writer.h"
+
+#include "../../utils/system.h"
+
+#include <iostream>
+
+using namespace std;
+
+namespace symbolic {
+PlanWriter::PlanWriter(const string &file_name, size_t max_queued)
+    : file_name(file_name),
+      file(file_name),
+      max_queued(max_queued),
+      num_added(0),
+      num_written(0),
+      done(false) {
+    if (!file) {
+        cerr << "Failed to open plan file: " << file_name << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    writer = thread(&PlanWriter::run, this);
+}
+
+PlanWriter::~PlanWriter() {
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        done = true;
+    }
+    not_empty.notify_one();
+    writer.join();
+}
+
+void PlanWriter::add_plan(string &&plan_text) {
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        not_full.wait(lock, [this]() {
+            return queue.size() < max_queued;
+        });
+        queue.push_back(move(plan_text));
+        ++num_added;
+    }
+    not_empty.notify_one();
+}
+
+void PlanWriter::wait_until_written() {
+    unique_lock<mutex> lock(queue_mutex);
+    written.wait(lock, [this]() {
+        return num_written == num_added;
+    });
+}
+
+void PlanWriter::run() {
+    unique_lock<mutex> lock(queue_mutex);
+    while (true) {
+        not_empty.wait(lock, [this]() {
+            return done || !queue.empty();
+        });
+        if (queue.empty()) {
+            break;
+        }
+        // Write the plan without holding the lock
+        string plan = move(queue.front());
+        queue.pop_front();
+        lock.unlock();
+        not_full.notify_all();
+        file << plan << flush;
+        if (!file) {
+            // exit_with throws, which would terminate this thread only
+            cerr << "Failed to write plan file: " << file_name << endl;
+            utils::exit_with_reentrant(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        lock.lock();
+        ++num_written;
+        written.notify_all();
+    }
+}
+}
@@ -0,0 +1,58 @@
+#ifndef SYMBOLIC_PLAN_SELECTION_PLAN_WRITER_H
+#define SYMBOLIC_PLAN_SELECTION_PLAN_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace symbolic {
+/*
+ * Writes plans to a single file with a background thread, so that the
+ * search does not wait for the file system. The plans are queued as text;
+ * if the queue holds max_queued plans, adding a plan waits until the writer
+ * has caught up. Each plan is flushed once it is written (a write error
+ * ends the planner) and the destructor writes all queued plans. Plans that are still queued when the planner is
+ * killed (e.g., on the time or memory limit) are lost.
+ */
+class PlanWriter {
+    std::string file_name;
+    std::ofstream file;
+    size_t max_queued;
+    int num_added;
+    int num_written;
+
+    std::deque<std::string> queue;
+    bool done;
+    mutable std::mutex queue_mutex;
+    std::condition_variable not_empty, not_full, written;
+    std::thread writer;
+
+    void run();
+
+public:
+    PlanWriter(const std::string &file_name, size_t max_queued);
+    ~PlanWriter();
+
+    PlanWriter(const PlanWriter &) = delete;
+    PlanWriter &operator=(const PlanWriter &) = delete;
+
+    void add_plan(std::string &&plan_text);
+    // Waits until all added plans are in the file
+    void wait_until_written();
+
+    const std::string &get_file_name() const {
+        return file_name;
+    }
+
+    // Number of plans in the file (queued plans are not counted)
+    int get_num_plans() const {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        return num_written;
+    }
+};
+}
+
+#endif
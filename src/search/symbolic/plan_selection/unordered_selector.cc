@@ -49,7 +49,9 @@ void UnorderedSelector::save_accepted_plan(
         }
     }
 
-    if (write_plans) {
+    if (plan_writer) {
+        stream_plan(ordered_plan);
+    } else if (write_plans) {
         plan_mgr.save_plan(
             ordered_plan, plan_mgr_task_proxy, dump_plans,
             num_desired_plans > 1);
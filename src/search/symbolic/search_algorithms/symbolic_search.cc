@@ -37,6 +37,11 @@ SymbolicSearch::SymbolicSearch(const plugins::Options &opts)
     cout << endl;
     vars->init();
     cout << endl;
+
+    string trace_file = opts.get<string>("trace_file");
+    if (!trace_file.empty()) {
+        trace = make_unique<SymTrace>(trace_file);
+    }
 }
 
 void SymbolicSearch::initialize() {
@@ -69,6 +74,27 @@ void SymbolicSearch::initialize() {
     plan_data_base->init(vars, search_task, get_plan_manager());
 }
 
+void SymbolicSearch::construct_cheaper_solutions(int bound) {
+    utils::Timer reconstruction_timer;
+    solution_registry->construct_cheaper_solutions(bound);
+    if (trace) {
+        trace->add_time("reconstruction", reconstruction_timer());
+    }
+}
+
+void SymbolicSearch::write_trace_layer() {
+    if (!trace) {
+        return;
+    }
+    trace->set("step", static_cast<long>(step_num));
+    trace->set("lower_bound", static_cast<long>(lower_bound));
+    trace->set("forest_nodes", vars->forest_node_count());
+    trace->set("cache_hit_rate", vars->cache_hit_rate());
+    trace->set("gc", vars->garbage_collections());
+    trace->set("reorder_time", vars->get_reordering_time());
+    trace->write_layer();
+}
+
 SearchStatus SymbolicSearch::step() {
     step_num++;
 
@@ -84,14 +110,13 @@ SearchStatus SymbolicSearch::step() {
 
     // Search finished!
     if (lower_bound >= upper_bound) {
-        solution_registry->construct_cheaper_solutions(
-            numeric_limits<int>::max());
+        construct_cheaper_solutions(numeric_limits<int>::max());
         solution_found = plan_data_base->get_num_reported_plan() > 0;
         cur_status = solution_found ? SOLVED : FAILED;
     } else {
         // Bound increased => construct plans
         if (lower_bound_increased) {
-            solution_registry->construct_cheaper_solutions(lower_bound);
+            construct_cheaper_solutions(lower_bound);
         }
 
         // All plans found
@@ -120,6 +145,9 @@ SearchStatus SymbolicSearch::step() {
     }
     lower_bound_increased = false;
 
+    if (cur_status != IN_PROGRESS) {
+        write_trace_layer();
+    }
     if (cur_status == SOLVED) {
         set_plan(plan_data_base->get_first_accepted_plan());
         cout << endl;
@@ -131,6 +159,7 @@ SearchStatus SymbolicSearch::step() {
 
     // Actuall step
     search->step();
+    write_trace_layer();
 
     return cur_status;
 }
@@ -161,6 +190,9 @@ void SymbolicSearch::print_statistics() const {
                  << solution_registry->get_num_found_plans() << endl;
     utils::g_log << "Plan reconstruction time: "
                  << solution_registry->get_reconstruction_time() << "s" << endl;
+    if (mgr) {
+        mgr->print_image_profile();
+    }
 }
 
 void SymbolicSearch::add_options_to_feature(plugins::Feature &feature) {
@@ -176,5 +208,11 @@ void SymbolicSearch::add_options_to_feature(plugins::Feature &feature) {
         "silent", "silent mode that avoids writing the cost bounds", "false");
     feature.add_option<bool>(
         "simple", "simple/loopless plan construction", "false");
+    feature.add_option<string>(
+        "trace_file",
+        "write a JSON line per search step to this file with the direction, "
+        "g value, frontier nodes, time of each phase and the BDD manager "
+        "statistics (empty = no trace)",
+        "\"\"");
 }
 }
@@ -4,6 +4,7 @@
 #include "../sym_enums.h"
 #include "../sym_parameters.h"
 #include "../sym_state_space_manager.h"
+#include "../sym_trace.h"
 
 #include "../../plugins/plugin.h"
 #include "../../search_algorithm.h"
@@ -53,8 +54,16 @@ protected:
 
     bool silent;
 
+    std::unique_ptr<SymTrace> trace; // Per-layer telemetry (if enabled)
+
     virtual void initialize() override;
 
+    // Constructs the plans cheaper than bound (timed in the trace)
+    void construct_cheaper_solutions(int bound);
+
+    // Adds the manager statistics to the trace and writes the current layer
+    void write_trace_layer();
+
     virtual SearchStatus step() override;
 
 public:
@@ -85,6 +94,14 @@ public:
 
     virtual void new_solution(const SymSolutionCut &sol);
 
+    SymTrace *get_trace() const {
+        return trace.get();
+    }
+
+    const std::shared_ptr<SymSolutionRegistry> &get_solution_registry() const {
+        return solution_registry;
+    }
+
     virtual void print_statistics() const override;
 
     virtual void save_plan_if_necessary() override;
@@ -41,13 +41,13 @@ SearchStatus TopqSymbolicUniformCostSearch::step() {
 
     // Search finished!
     if (lower_bound >= upper_bound) {
-        solution_registry->construct_cheaper_solutions(upper_bound);
+        construct_cheaper_solutions(upper_bound);
         solution_found = plan_data_base->get_num_reported_plan() > 0;
         cur_status = solution_found ? SOLVED : FAILED;
     } else {
         // Bound increade => construct plans
         if (lower_bound_increased) {
-            solution_registry->construct_cheaper_solutions(lower_bound);
+            construct_cheaper_solutions(lower_bound);
         }
 
         // All plans found
@@ -70,6 +70,9 @@ SearchStatus TopqSymbolicUniformCostSearch::step() {
     }
     lower_bound_increased = false;
 
+    if (cur_status != IN_PROGRESS) {
+        write_trace_layer();
+    }
     if (cur_status == SOLVED) {
         set_plan(plan_data_base->get_first_accepted_plan());
         cout << endl;
@@ -81,6 +84,7 @@ SearchStatus TopqSymbolicUniformCostSearch::step() {
 
     // Actuall step
     search->step();
+    write_trace_layer();
 
     return cur_status;
 }
@@ -2,11 +2,19 @@
 
 #include "../search_algorithms/symbolic_search.h"
 
+#include "../../utils/logging.h"
+
 #include <memory>
 
 using namespace std;
 
 namespace symbolic {
+// Predicted step time (seconds) below which no direction is considered to
+// blow up
+static const double MIN_BLOWUP_TIME = 1.0;
+// Same for the predicted nodes of the image
+static const double MIN_BLOWUP_NODES = 1000000.0;
+
 BidirectionalSearch::BidirectionalSearch(
     SymbolicSearch *eng, const SymParameters &params,
     shared_ptr<UniformCostSearch> _fw, shared_ptr<UniformCostSearch> _bw,
@@ -15,7 +23,8 @@ BidirectionalSearch::BidirectionalSearch(
       fw(_fw),
       bw(_bw),
       cur_dir(nullptr),
-      alternating(alternating) {
+      alternating(alternating),
+      single_dir(nullptr) {
     assert(fw->getStateSpace() == bw->getStateSpace());
     mgr = fw->getStateSpaceShared();
 }
@@ -43,6 +52,11 @@ UniformCostSearch *BidirectionalSearch::selectBestDirection() {
             bw_est.set_data(bw_est.get_time(), bw_est.get_nodes(), false);
             return fw.get();
         }
+        if (sym_params.direction_selection == DirectionSelection::PREDICTION &&
+            fw_est.get_failed() == bw_est.get_failed()) {
+            selectPredictedDirection();
+            return cur_dir.get();
+        }
         /*utils::g_log << "FWD: " << fw_est << endl;
         utils::g_log << "BWD: " << bw_est << endl;
         utils::g_log << ((bw_est < fw_est) ? "bw" : "fw") << endl;*/
@@ -52,6 +66,55 @@ UniformCostSearch *BidirectionalSearch::selectBestDirection() {
     return cur_dir.get();
 }
 
+void BidirectionalSearch::selectPredictedDirection() {
+    if (single_dir) {
+        cur_dir = single_dir;
+        return;
+    }
+
+    double fw_time = fw->predict_step_time();
+    double bw_time = bw->predict_step_time();
+    if (fw_time < 0 || bw_time < 0) {
+        // Without a step in some direction, there is nothing to predict yet
+        cur_dir = fw_time < 0 ? fw : bw;
+        return;
+    }
+    double fw_nodes = fw->predict_image_nodes();
+    double bw_nodes = bw->predict_image_nodes();
+
+    // The faster direction, unless only its image is predicted to exceed the
+    // nodes alloted to a step
+    double max_nodes = sym_params.max_alloted_nodes;
+    bool fw_fits = max_nodes <= 0 || fw_nodes <= max_nodes;
+    bool bw_fits = max_nodes <= 0 || bw_nodes <= max_nodes;
+    if (fw_fits != bw_fits) {
+        cur_dir = fw_fits ? fw : bw;
+    } else {
+        cur_dir = (bw_time < fw_time) ? bw : fw;
+    }
+
+    // The other direction blows up if it is predicted to be worse in both
+    // time and image nodes, and by the blowup factor in one of them
+    bool cur_fw = cur_dir == fw;
+    double cur_time = cur_fw ? fw_time : bw_time;
+    double other_time = cur_fw ? bw_time : fw_time;
+    double cur_nodes = cur_fw ? fw_nodes : bw_nodes;
+    double other_nodes = cur_fw ? bw_nodes : fw_nodes;
+    double factor = sym_params.direction_blowup_factor;
+    bool time_blowup =
+        other_time > MIN_BLOWUP_TIME && other_time > factor * cur_time;
+    bool nodes_blowup =
+        other_nodes > MIN_BLOWUP_NODES && other_nodes > factor * cur_nodes;
+    if (factor > 0 && other_time >= cur_time && other_nodes >= cur_nodes &&
+        (time_blowup || nodes_blowup)) {
+        single_dir = cur_dir;
+        utils::g_log << "Predicted step time fw=" << fw_time
+                     << "s bw=" << bw_time << "s, image nodes fw=" << fw_nodes
+                     << " bw=" << bw_nodes << ": continuing only "
+                     << single_dir->get_last_dir() << endl;
+    }
+}
+
 bool BidirectionalSearch::finished() const {
     return fw->finished() || bw->finished();
 }
@@ -10,10 +10,16 @@ private:
     std::shared_ptr<UniformCostSearch> fw, bw;
     std::shared_ptr<UniformCostSearch> cur_dir;
     bool alternating;
+    // Direction used exclusively once the other one blew up (or nullptr)
+    std::shared_ptr<UniformCostSearch> single_dir;
 
     // Returns the best direction to search the bd exp
     UniformCostSearch *selectBestDirection();
 
+    // Selects the direction with the lower predicted time of the next step,
+    // avoiding directions whose image is predicted to exceed the node limit
+    void selectPredictedDirection();
+
 public:
     BidirectionalSearch(
         SymbolicSearch *eng, const SymParameters &params,
@@ -12,6 +12,11 @@ protected:
 
     virtual void filterFrontier() override;
 
+    // States are reopened with higher costs to find further plans
+    virtual bool closes_states_once() const override {
+        return false;
+    }
+
 public:
     TopkUniformCostSearch(SymbolicSearch *eng, const SymParameters &params)
         : UniformCostSearch(eng, params) {
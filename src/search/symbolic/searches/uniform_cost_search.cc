@@ -2,6 +2,7 @@
 
 #include "../closed_list.h"
 #include "../frontier.h"
+#include "../sym_trace.h"
 #include "../sym_utils.h"
 
 #include "../../utils/timer.h"
@@ -37,7 +38,24 @@ bool UniformCostSearch::init(
     BDD init_bdd = fw ? mgr->get_initial_state() : mgr->get_goal();
     frontier.init(manager.get(), init_bdd);
 
-    closed->init(mgr.get());
+    int closed_layers = 0;
+    if (closes_states_once()) {
+        closed_layers =
+            sym_params.add_layers ? 1 : sym_params.closed_compaction;
+    }
+    open_list.init(
+        mgr.get(), closes_states_once() && sym_params.add_layers,
+        sym_params.open_merge_nodes);
+    closed->init(mgr.get(), closed_layers);
+    if (sym_params.mutex_care_set) {
+        closed->set_care_set(mgr->get_care_set(fw));
+    }
+    if (closes_states_once() && closed_layers == 0 &&
+        sym_params.closed_spill_layers > 0) {
+        closed->set_spilling(
+            sym_params.closed_spill_layers, sym_params.closed_spill_dir,
+            fw ? "fw" : "bw");
+    }
     closed->insert(0, init_bdd);
 
     if (opposite_search) {
@@ -60,6 +78,21 @@ bool UniformCostSearch::init(
     return true;
 }
 
+void UniformCostSearch::trace_time(
+    const string &phase, const utils::Timer &timer) {
+    if (SymTrace *trace = engine->get_trace()) {
+        trace->add_time(phase, timer());
+    }
+}
+
+void UniformCostSearch::trace_truncated(TruncatedReason reason) {
+    if (SymTrace *trace = engine->get_trace()) {
+        ostringstream reason_name;
+        reason_name << reason;
+        trace->set("truncated", reason_name.str());
+    }
+}
+
 void UniformCostSearch::checkFrontierCut(Bucket &bucket, int g) {
     if (sym_params.non_stop) {
         return;
@@ -88,9 +121,17 @@ bool UniformCostSearch::prepareBucket() {
         open_list.pop(frontier);
         last_g_cost = frontier.g();
         assert(!frontier.empty() || frontier.g() == numeric_limits<int>::max());
-        checkFrontierCut(frontier.bucket(), frontier.g());
+        if (sym_params.fused_filter && closes_states_once()) {
+            filterFrontierFused();
+        } else {
+            utils::Timer filter_timer;
+            checkFrontierCut(frontier.bucket(), frontier.g());
+            trace_time("cut_check", filter_timer);
 
-        filterFrontier();
+            filter_timer.reset();
+            filterFrontier();
+            trace_time("mutex_filter", filter_timer);
+        }
 
         // Close and move to reopen
         if (!lastStepCost || frontier.g() != 0) {
@@ -119,16 +160,54 @@ void UniformCostSearch::filterFrontier() {
     remove_zero(frontier.bucket());
 }
 
+void UniformCostSearch::filterFrontierFused() {
+    Bucket &bucket = frontier.bucket();
+    utils::Timer filter_timer;
+    mgr->merge_bucket(bucket);
+    trace_time("merge", filter_timer);
+
+    filter_timer.reset();
+    vector<BDD> constraints{closed->notClosed()};
+    if (!sym_params.non_stop) {
+        for (const BDD &bdd : bucket) {
+            auto sol = perfectHeuristic->getCheapestCut(bdd, frontier.g(), fw);
+            if (sol.get_f() >= 0) {
+                engine->new_solution(sol);
+            }
+        }
+        constraints.push_back(perfectHeuristic->notClosed());
+    }
+    trace_time("cut_check", filter_timer);
+
+    filter_timer.reset();
+    mgr->filter_bucket(bucket, constraints, fw, initialization());
+    trace_time("mutex_filter", filter_timer);
+}
+
 void UniformCostSearch::stepImage(int maxTime, int maxNodes) {
     utils::Timer step_timer;
+    SymTrace *trace = engine->get_trace();
+    if (trace) {
+        trace->set("dir", get_last_dir());
+    }
     bool done = prepareBucket();
     if (done) {
         return;
     }
 
+    if (trace) {
+        trace->set("g", static_cast<long>(frontier.g()));
+        frontier.trace_nodes(*trace);
+    }
+    int frontier_nodes = frontier.nodes();
     Result prepare_res =
         frontier.prepare(maxTime, maxNodes, fw, initialization());
+    if (trace) {
+        trace->add_time("mutex_filter", frontier.get_filter_time());
+        trace->add_time("merge", frontier.get_merge_time());
+    }
     if (!prepare_res.ok) {
+        trace_truncated(prepare_res.truncated_reason);
         step_estimation.set_data(
             step_timer(), frontier.nodes(), !prepare_res.ok);
         return;
@@ -138,8 +217,20 @@ void UniformCostSearch::stepImage(int maxTime, int maxNodes) {
         return; // Skip image if we are done
     }
 
+    if (trace) {
+        frontier.trace_nodes(*trace);
+    }
     int stepNodes = frontier.nodes();
+    long image_nodes = 0;
     ResultExpansion res_expansion = frontier.expand(maxTime, maxNodes, fw);
+    if (trace) {
+        trace->add_time(
+            res_expansion.step_zero ? "zero_image" : "cost_image",
+            res_expansion.time_spent);
+    }
+    if (!res_expansion.ok) {
+        trace_truncated(res_expansion.truncated_reason);
+    }
 
     if (res_expansion.ok) {
         lastStepCost = false; // Must be set to false before calling checkCut
@@ -148,13 +239,18 @@ void UniformCostSearch::stepImage(int maxTime, int maxNodes) {
         for (auto &resImage : res_expansion.buckets) {
             for (auto &pairCostBDDs : resImage) {
                 int cost = frontier.g() + pairCostBDDs.first;
+                utils::Timer phase_timer;
                 mgr->merge_bucket(pairCostBDDs.second);
+                trace_time("merge", phase_timer);
 
+                phase_timer.reset();
                 checkFrontierCut(pairCostBDDs.second, cost);
+                trace_time("cut_check", phase_timer);
 
                 for (auto &bdd : pairCostBDDs.second) {
                     if (!bdd.IsZero()) {
                         stepNodes = max(stepNodes, bdd.nodeCount());
+                        image_nodes += bdd.nodeCount();
                         open_list.insert(bdd, cost);
                     }
                 }
@@ -168,5 +264,11 @@ void UniformCostSearch::stepImage(int maxTime, int maxNodes) {
 
     engine->setLowerBound(getG() + mgr->get_min_transition_cost());
     step_estimation.set_data(step_timer(), stepNodes, !res_expansion.ok);
+    if (res_expansion.ok) {
+        step_predictor.add_step(frontier_nodes, step_timer(), image_nodes);
+    }
+
+    // Between layers, so that no operation is interrupted by reordering
+    mgr->reorder_if_grown();
 }
 }
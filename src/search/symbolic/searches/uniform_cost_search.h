@@ -11,6 +11,8 @@
 #include "../sym_state_space_manager.h"
 #include "../sym_utils.h"
 
+#include "../../utils/timer.h"
+
 #include <memory>
 
 namespace symbolic {
@@ -36,6 +38,7 @@ protected:
     bool fw; // Direction of the search. true=forward, false=backward
 
     Estimation step_estimation;
+    StepPredictor step_predictor;
 
     // Current state of the search:
     std::shared_ptr<ClosedList> closed; // Closed list is a shared ptr to share
@@ -53,6 +56,10 @@ protected:
     void violated(
         TruncatedReason reason, double time, int maxTime, int maxNodes);
 
+    // Adds the time of the timer to a phase of the trace (if enabled)
+    void trace_time(const std::string &phase, const utils::Timer &timer);
+    void trace_truncated(TruncatedReason reason);
+
     bool initialization() const {
         return frontier.g() == 0 && lastStepCost;
     }
@@ -73,6 +80,16 @@ protected:
 
     virtual void filterFrontier();
 
+    // Merges the frontier bucket, checks it for cuts and removes the closed
+    // states of both directions and the mutex states in one pass
+    void filterFrontierFused();
+
+    // Whether each state is closed with a single g value, which allows to
+    // represent the open and closed lists with ADDs
+    virtual bool closes_states_once() const {
+        return true;
+    }
+
     //////////////////////////////////////////////////////////////////////////////
 public:
     UniformCostSearch(SymbolicSearch *eng, const SymParameters &params);
@@ -87,11 +104,11 @@ public:
     }
 
     void step() override {
-        /*if (step_estimation.get_failed()) {
-            p.increase_bound();
+        // A truncated step is resumed with larger bounds
+        if (step_estimation.get_failed()) {
+            sym_params.increase_bound();
         }
-        stepImage(p.max_alloted_time, p.max_alloted_nodes);*/
-        stepImage(0, 0);
+        stepImage(sym_params.max_alloted_time, sym_params.max_alloted_nodes);
     }
 
     virtual std::string get_last_dir() const override {
@@ -127,6 +144,16 @@ public:
         return &step_estimation;
     }
 
+    // Predicted time (seconds) of the next step or -1 if unknown
+    double predict_step_time() const {
+        return step_predictor.predict_time(frontier.nodes());
+    }
+
+    // Predicted nodes of the image of the next step or -1 if unknown
+    double predict_image_nodes() const {
+        return step_predictor.predict_image_nodes(frontier.nodes());
+    }
+
     // void write(const std::string & file) const;
 
     void filter_mutex(Bucket &bucket) {
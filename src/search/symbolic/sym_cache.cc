@@ -0,0 +1,227 @@
+#include "sym_cache.h"
+
+#include "sym_variables.h"
+
+#include "../abstract_task.h"
+#include "../mutex_group.h"
+#include "../utils/logging.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Included last: the Cudd util header defines macros such as fail and MAX.
+#include "dddmp.h"
+
+using namespace std;
+
+namespace symbolic {
+// 64-bit FNV-1a, which (unlike std::hash) is stable across runs and builds
+static uint64_t fnv1a(const string &text) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void write_fact(ostream &os, const FactPair &fact) {
+    os << fact.var << "=" << fact.value << " ";
+}
+
+SymCache::SymCache(const string &cache_dir, const AbstractTask &task)
+    : directory(cache_dir + "/" + compute_task_hash(task)) {
+    error_code ec;
+    filesystem::create_directories(directory, ec);
+    if (ec) {
+        utils::g_log << "Could not create cache directory " << directory
+                     << ": " << ec.message() << endl;
+    }
+}
+
+string SymCache::compute_task_hash(const AbstractTask &task) {
+    ostringstream task_text;
+    for (int var = 0; var < task.get_num_variables(); ++var) {
+        task_text << "var " << task.get_variable_name(var) << " "
+                  << task.get_variable_domain_size(var) << " "
+                  << task.get_variable_axiom_layer(var) << " "
+                  << task.get_variable_default_axiom_value(var) << "\n";
+        for (int val = 0; val < task.get_variable_domain_size(var); ++val) {
+            task_text << task.get_fact_name(FactPair(var, val)) << "\n";
+        }
+    }
+    for (bool is_axiom : {false, true}) {
+        int num_ops =
+            is_axiom ? task.get_num_axioms() : task.get_num_operators();
+        for (int op = 0; op < num_ops; ++op) {
+            task_text << (is_axiom ? "axiom " : "op ")
+                      << task.get_operator_name(op, is_axiom) << " "
+                      << task.get_operator_cost(op, is_axiom) << "\npre ";
+            for (int i = 0;
+                 i < task.get_num_operator_preconditions(op, is_axiom); ++i) {
+                write_fact(
+                    task_text, task.get_operator_precondition(op, i, is_axiom));
+            }
+            for (int eff = 0; eff < task.get_num_operator_effects(op, is_axiom);
+                 ++eff) {
+                task_text << "\neff ";
+                for (int i = 0; i < task.get_num_operator_effect_conditions(
+                                        op, eff, is_axiom);
+                     ++i) {
+                    write_fact(
+                        task_text, task.get_operator_effect_condition(
+                                       op, eff, i, is_axiom));
+                }
+                task_text << "-> ";
+                write_fact(
+                    task_text, task.get_operator_effect(op, eff, is_axiom));
+            }
+            task_text << "\n";
+        }
+    }
+    task_text << "init ";
+    for (int value : task.get_initial_state_values()) {
+        task_text << value << " ";
+    }
+    task_text << "\ngoal ";
+    for (int i = 0; i < task.get_num_goals(); ++i) {
+        write_fact(task_text, task.get_goal_fact(i));
+    }
+    for (const MutexGroup &mutex_group : task.get_mutex_groups()) {
+        task_text << "\nmutex " << mutex_group.detectedFW() << " ";
+        for (const FactPair &fact : mutex_group.getFacts()) {
+            write_fact(task_text, fact);
+        }
+    }
+    return compute_hash(task_text.str());
+}
+
+string SymCache::compute_hash(const string &text) {
+    ostringstream hash;
+    hash << hex << setw(16) << setfill('0') << fnv1a(text);
+    return hash.str();
+}
+
+string SymCache::get_path(const string &name) const {
+    return directory + "/" + name;
+}
+
+bool SymCache::load_ints(const string &name, vector<int> &values) const {
+    ifstream file(get_path(name) + ".txt");
+    if (!file) {
+        return false;
+    }
+    size_t num_values;
+    if (!(file >> num_values)) {
+        return false;
+    }
+    vector<int> loaded(num_values);
+    for (int &value : loaded) {
+        if (!(file >> value)) {
+            return false;
+        }
+    }
+    values.swap(loaded);
+    return true;
+}
+
+void SymCache::save_ints(const string &name, const vector<int> &values) const {
+    // Write to a temporary file first, so that concurrent runs never read a
+    // partially written entry.
+    string path = get_path(name) + ".txt";
+    string tmp_path = path + ".tmp";
+    {
+        ofstream file(tmp_path);
+        file << values.size() << "\n";
+        for (int value : values) {
+            file << value << " ";
+        }
+        file << "\n";
+        if (!file) {
+            utils::g_log << "Could not write cache entry " << path << endl;
+            return;
+        }
+    }
+    error_code ec;
+    filesystem::rename(tmp_path, path, ec);
+}
+
+bool SymCache::read_bdd_file(
+    const SymVariables &sym_vars, const string &path, int num_bdds,
+    vector<BDD> &bdds) {
+    if (!filesystem::exists(path)) {
+        return false;
+    }
+    Cudd *manager = sym_vars.get_manager();
+    DdNode **roots = nullptr;
+    int num_roots = Dddmp_cuddBddArrayLoad(
+        manager->getManager(), DDDMP_ROOT_MATCHLIST, nullptr,
+        DDDMP_VAR_MATCHIDS, nullptr, nullptr, nullptr, DDDMP_MODE_BINARY,
+        const_cast<char *>(path.c_str()), nullptr, &roots);
+    if (num_roots != num_bdds || roots == nullptr) {
+        free(roots);
+        return false;
+    }
+    vector<BDD> loaded;
+    for (int i = 0; i < num_roots; ++i) {
+        loaded.emplace_back(*manager, roots[i]);
+        // dddmp references the loaded roots, and so does the BDD
+        Cudd_RecursiveDeref(manager->getManager(), roots[i]);
+    }
+    free(roots);
+    bdds.swap(loaded);
+    return true;
+}
+
+bool SymCache::write_bdd_file(
+    const SymVariables &sym_vars, const string &path,
+    const vector<BDD> &bdds) {
+    vector<DdNode *> roots;
+    roots.reserve(bdds.size());
+    for (const BDD &bdd : bdds) {
+        roots.push_back(bdd.getNode());
+    }
+    int stored = Dddmp_cuddBddArrayStore(
+        sym_vars.get_manager()->getManager(), nullptr, roots.size(),
+        roots.data(), nullptr, nullptr, nullptr, DDDMP_MODE_BINARY,
+        DDDMP_VARIDS, const_cast<char *>(path.c_str()), nullptr);
+    return stored == DDDMP_SUCCESS;
+}
+
+bool SymCache::load_bdds(
+    const SymVariables &sym_vars, const string &name,
+    vector<BDD> &bdds) const {
+    vector<int> num_bdds;
+    if (!load_ints(name, num_bdds) || num_bdds.size() != 1) {
+        return false;
+    }
+    if (num_bdds[0] == 0) {
+        bdds.clear();
+        return true;
+    }
+    return read_bdd_file(
+        sym_vars, get_path(name) + ".bdd", num_bdds[0], bdds);
+}
+
+void SymCache::save_bdds(
+    const SymVariables &sym_vars, const string &name,
+    const vector<BDD> &bdds) const {
+    if (!bdds.empty()) {
+        string path = get_path(name) + ".bdd";
+        string tmp_path = path + ".tmp";
+        if (!write_bdd_file(sym_vars, tmp_path, bdds)) {
+            utils::g_log << "Could not write cache entry " << path << endl;
+            return;
+        }
+        error_code ec;
+        filesystem::rename(tmp_path, path, ec);
+    }
+    // The number of BDDs is written last: it marks the entry as complete.
+    save_ints(name, {static_cast<int>(bdds.size())});
+}
+}
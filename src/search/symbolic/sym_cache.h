@@ -0,0 +1,60 @@
+#ifndef SYMBOLIC_SYM_CACHE_H
+#define SYMBOLIC_SYM_CACHE_H
+
+#include "cuddObj.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class AbstractTask;
+
+namespace symbolic {
+class SymVariables;
+
+/*
+ * Persistent cache of the symbolic task representation on disk. Each task is
+ * stored in a directory named by a hash of the SAS+ task, and each entry is
+ * stored as a pair of files: <name>.txt with plain integers and <name>.bdd
+ * with the BDDs in the dddmp binary format. Loading fails gracefully if an
+ * entry does not exist (or is corrupted), so that it is simply recomputed.
+ */
+class SymCache {
+    std::string directory;
+
+    std::string get_path(const std::string &name) const;
+
+public:
+    SymCache(const std::string &cache_dir, const AbstractTask &task);
+
+    static std::string compute_task_hash(const AbstractTask &task);
+
+    // Hash of a string, e.g., the parameters that an entry depends on.
+    static std::string compute_hash(const std::string &text);
+
+    bool load_ints(const std::string &name, std::vector<int> &values) const;
+    void save_ints(
+        const std::string &name, const std::vector<int> &values) const;
+
+    bool load_bdds(
+        const SymVariables &sym_vars, const std::string &name,
+        std::vector<BDD> &bdds) const;
+    void save_bdds(
+        const SymVariables &sym_vars, const std::string &name,
+        const std::vector<BDD> &bdds) const;
+
+    // Reads and writes BDDs in the dddmp binary format. Reading fails if the
+    // file does not contain num_bdds BDDs.
+    static bool read_bdd_file(
+        const SymVariables &sym_vars, const std::string &path, int num_bdds,
+        std::vector<BDD> &bdds);
+    static bool write_bdd_file(
+        const SymVariables &sym_vars, const std::string &path,
+        const std::vector<BDD> &bdds);
+
+    const std::string &get_directory() const {
+        return directory;
+    }
+};
+}
+#endif
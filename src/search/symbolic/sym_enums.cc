@@ -26,6 +26,21 @@ static plugins::TypedEnumPlugin<ConditionalEffectsTransitionType> _conditional_e
      {"dynamic",
       "tries to use variable-based for each transition relation, and if this does not succeed, falls back to effect-based, always with early quantification of variables"}});
 
+static plugins::TypedEnumPlugin<TransitionMergeStrategy> _transition_merge_strategy_enum_plugin(
+    {{"index",
+      "merges neighbouring transition relations in the order of the operators"},
+     {"affinity",
+      "orders the transition relations so that the ones with similar effect and precondition variables are merged first"}});
+
+static plugins::TypedEnumPlugin<ReorderingMethod> _reordering_method_enum_plugin(
+    {{"sift", "sifting of variable groups"},
+     {"group_sift", "group sifting, which also creates groups of variables that stay together"},
+     {"symm_sift", "symmetric sifting, which groups symmetric variables"}});
+
+static plugins::TypedEnumPlugin<DirectionSelection> _direction_selection_enum_plugin(
+    {{"estimation", "the direction whose last step took less time (and nodes)"},
+     {"prediction", "the direction whose next step is predicted to take less time, fitting the step time and the image nodes as powers of the frontier size; a direction whose image is predicted to exceed max_alloted_nodes is avoided"}});
+
 ostream &operator<<(ostream &os, const MutexType &m) {
     switch (m) {
     case MutexType::MUTEX_NOT:
@@ -64,6 +79,44 @@ ostream &operator<<(
     }
 }
 
+ostream &operator<<(ostream &os, const TransitionMergeStrategy &strategy) {
+    switch (strategy) {
+    case TransitionMergeStrategy::INDEX:
+        return os << "index";
+    case TransitionMergeStrategy::AFFINITY:
+        return os << "affinity";
+    default:
+        cerr << "Name of TransitionMergeStrategy not known";
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+ostream &operator<<(ostream &os, const ReorderingMethod &method) {
+    switch (method) {
+    case ReorderingMethod::SIFT:
+        return os << "sift";
+    case ReorderingMethod::GROUP_SIFT:
+        return os << "group_sift";
+    case ReorderingMethod::SYMM_SIFT:
+        return os << "symm_sift";
+    default:
+        cerr << "Name of ReorderingMethod not known";
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+ostream &operator<<(ostream &os, const DirectionSelection &sel) {
+    switch (sel) {
+    case DirectionSelection::ESTIMATION:
+        return os << "estimation";
+    case DirectionSelection::PREDICTION:
+        return os << "prediction";
+    default:
+        cerr << "Name of DirectionSelection not known";
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
 ostream &operator<<(ostream &os, const Dir &dir) {
     switch (dir) {
     case Dir::FW:
@@ -78,6 +131,24 @@ ostream &operator<<(ostream &os, const Dir &dir) {
     }
 }
 
+ostream &operator<<(ostream &os, const TruncatedReason &reason) {
+    switch (reason) {
+    case TruncatedReason::FILTER_MUTEX:
+        return os << "filter_mutex";
+    case TruncatedReason::MERGE_BUCKET:
+        return os << "merge_bucket";
+    case TruncatedReason::MERGE_BUCKET_COST:
+        return os << "merge_bucket_cost";
+    case TruncatedReason::IMAGE_ZERO:
+        return os << "image_zero";
+    case TruncatedReason::IMAGE_COST:
+        return os << "image_cost";
+    default:
+        cerr << "Name of TruncatedReason not known";
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
 bool is_ce_transition_type_early_quantification(
     const ConditionalEffectsTransitionType &ce_type) {
     return ce_type == ConditionalEffectsTransitionType::
@@ -30,6 +30,29 @@ extern bool is_ce_transition_type_variable_based(
 extern bool is_ce_transition_type_conjunctive(
     const ConditionalEffectsTransitionType &ce_type);
 
+// How the transition relations of the same cost are paired for merging
+enum class TransitionMergeStrategy {
+    INDEX,
+    AFFINITY,
+};
+std::ostream &operator<<(
+    std::ostream &os, const TransitionMergeStrategy &strategy);
+
+// Sifting algorithm used to reorder the BDD variables during the search
+enum class ReorderingMethod {
+    SIFT,
+    GROUP_SIFT,
+    SYMM_SIFT,
+};
+std::ostream &operator<<(std::ostream &os, const ReorderingMethod &method);
+
+// How the bidirectional search decides which direction is expanded next
+enum class DirectionSelection {
+    ESTIMATION,
+    PREDICTION,
+};
+std::ostream &operator<<(std::ostream &os, const DirectionSelection &sel);
+
 enum class Dir {
     FW,
     BW,
@@ -45,5 +68,6 @@ enum class TruncatedReason {
     IMAGE_ZERO,
     IMAGE_COST
 };
+std::ostream &operator<<(std::ostream &os, const TruncatedReason &reason);
 }
 #endif
@@ -6,6 +6,7 @@
 #include "../utils/logging.h"
 
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace std;
@@ -33,6 +34,66 @@ bool Estimation::operator<(const Estimation &other) const {
     return this->nodes < other.nodes;
 }
 
+// Number of recent steps used to fit the prediction and bounds of the fitted
+// exponent
+static const size_t PREDICTOR_WINDOW = 8;
+static const double MIN_EXPONENT = 0.0;
+static const double MAX_EXPONENT = 3.0;
+
+static void add_point(
+    deque<pair<double, double>> &history, double nodes, double value) {
+    history.emplace_back(nodes, value);
+    if (history.size() > PREDICTOR_WINDOW) {
+        history.pop_front();
+    }
+}
+
+// Fits value = a * nodes^b to the history and evaluates it for nodes
+static double predict(
+    const deque<pair<double, double>> &history, double nodes) {
+    if (history.empty()) {
+        return -1;
+    }
+    nodes = max(nodes, 1.0);
+
+    double n = history.size();
+    double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+    for (const auto &[step_nodes, value] : history) {
+        double x = log(step_nodes);
+        double y = log(value);
+        sum_x += x;
+        sum_y += y;
+        sum_xx += x * x;
+        sum_xy += x * y;
+    }
+    double var_x = sum_xx - sum_x * sum_x / n;
+    if (history.size() < 2 || var_x < 1e-6) {
+        // Not enough different frontier sizes: scale the last step linearly
+        const auto &[last_nodes, last_value] = history.back();
+        return last_value * nodes / last_nodes;
+    }
+    double exponent = (sum_xy - sum_x * sum_y / n) / var_x;
+    exponent = min(max(exponent, MIN_EXPONENT), MAX_EXPONENT);
+    double log_factor = (sum_y - exponent * sum_x) / n;
+    return exp(log_factor + exponent * log(nodes));
+}
+
+void StepPredictor::add_step(double nodes, double time, double image_nodes) {
+    // Avoid log(0) for empty frontiers, empty images and steps below the
+    // timer resolution
+    nodes = max(nodes, 1.0);
+    add_point(time_history, nodes, max(time, 1e-4));
+    add_point(nodes_history, nodes, max(image_nodes, 1.0));
+}
+
+double StepPredictor::predict_time(double nodes) const {
+    return predict(time_history, nodes);
+}
+
+double StepPredictor::predict_image_nodes(double nodes) const {
+    return predict(nodes_history, nodes);
+}
+
 ostream &operator<<(ostream &os, const Estimation &est) {
     return os << "{Time=" << est.time << ",Nodes=" << est.nodes
               << ",Failed=" << est.failed << "}";
@@ -1,6 +1,7 @@
 #ifndef SYMBOLIC_SYM_ESTIMATE_H
 #define SYMBOLIC_SYM_ESTIMATE_H
 
+#include <deque>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -34,5 +35,30 @@ public:
 
     friend std::ostream &operator<<(std::ostream &os, const Estimation &est);
 };
+
+/*
+ * Predicts the time and the memory of the next step of a search from the
+ * last steps. The time of a step (including the mutex filtering, the image
+ * and the merge of the resulting buckets) and the nodes of its image are
+ * each modelled as a * nodes^b, where nodes is the size of the frontier that
+ * is expanded. The parameters are fitted by least squares in log space over
+ * the last steps. With a single step, both are assumed to grow linearly with
+ * the frontier.
+ */
+class StepPredictor {
+    // Pairs of frontier nodes and step time (seconds)
+    std::deque<std::pair<double, double>> time_history;
+    // Pairs of frontier nodes and image nodes
+    std::deque<std::pair<double, double>> nodes_history;
+
+public:
+    void add_step(double nodes, double time, double image_nodes);
+
+    // Predicted time of a step that expands the given number of nodes or -1
+    // if no step has been recorded yet
+    double predict_time(double nodes) const;
+    // Same for the nodes of the image
+    double predict_image_nodes(double nodes) const;
+};
 }
 #endif
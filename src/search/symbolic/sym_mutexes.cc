@@ -1,7 +1,15 @@
 #include "sym_mutexes.h"
 
+#include "h2_mutexes.h"
+#include "sym_cache.h"
 #include "sym_utils.h"
 
+#include "../utils/logging.h"
+
+#include <cassert>
+#include <numeric>
+#include <sstream>
+
 using namespace std;
 
 namespace symbolic {
@@ -13,7 +21,20 @@ void SymMutexes::init(const shared_ptr<AbstractTask> task) {
     if (sym_params.mutex_type == MutexType::MUTEX_NOT)
         return; // Skip mutex initialization
 
-    const vector<MutexGroup> &mutex_groups = task->get_mutex_groups();
+    if (load_from_cache(task)) {
+        utils::g_log << "Mutex BDDs loaded from cache." << endl;
+        return;
+    }
+
+    vector<MutexGroup> mutex_groups = task->get_mutex_groups();
+    if (sym_params.h2_mutexes) {
+        vector<FactPair> unreachable_facts_fw, unreachable_facts_bw;
+        H2Mutexes(task).compute(
+            sym_params.max_h2_time / 1000.0, mutex_groups,
+            unreachable_facts_fw, unreachable_facts_bw);
+        init_dead_ends(unreachable_facts_fw, notDeadEndFw);
+        init_dead_ends(unreachable_facts_bw, notDeadEndBw);
+    }
     // If (a) is initialized OR not using mutex OR edeletion does not need mutex
 
     bool genMutexBDD = true;
@@ -31,15 +52,113 @@ void SymMutexes::init(const shared_ptr<AbstractTask> task) {
             }
         }
     }
-    init(task, genMutexBDD, genMutexBDDByFluent, false);
-    init(task, genMutexBDD, genMutexBDDByFluent, true);
+    init(task, mutex_groups, genMutexBDD, genMutexBDDByFluent, false);
+    init(task, mutex_groups, genMutexBDD, genMutexBDDByFluent, true);
+    save_to_cache();
 }
 
-void SymMutexes::init(
-    const shared_ptr<AbstractTask> task, bool genMutexBDD,
-    bool genMutexBDDByFluent, bool fw) {
-    const vector<MutexGroup> &mutex_groups = task->get_mutex_groups();
+string SymMutexes::get_cache_name() const {
+    ostringstream params;
+    params << sym_params.mutex_type << " " << sym_params.max_mutex_size << " "
+           << sym_params.max_mutex_time << " " << sym_params.h2_mutexes << " "
+           << sym_params.max_h2_time << "\n";
+    for (int var : sym_vars->get_var_order()) {
+        params << var << " ";
+    }
+    return "mutexes_" + SymCache::compute_hash(params.str());
+}
+
+/*
+ * The cache entry stores the number of BDDs of each vector (the vectors by
+ * fluent are flattened) followed by all BDDs in the same order.
+ */
+bool SymMutexes::load_from_cache(const shared_ptr<AbstractTask> &task) {
+    const SymCache *cache = sym_vars->get_cache();
+    vector<int> layout;
+    vector<int> var_order;
+    vector<BDD> bdds;
+    if (!cache || !cache->load_ints(get_cache_name() + "_order", var_order) ||
+        var_order != sym_vars->get_var_order() ||
+        !cache->load_ints(get_cache_name() + "_layout", layout) ||
+        layout.size() != 7 ||
+        !cache->load_bdds(*sym_vars, get_cache_name(), bdds) ||
+        static_cast<int>(bdds.size()) !=
+            accumulate(layout.begin(), layout.end(), 0)) {
+        return false;
+    }
+
+    auto it = bdds.begin();
+    auto load_vector = [&it](vector<BDD> &res, int size) {
+        res.assign(it, it + size);
+        it += size;
+    };
+    auto load_by_fluent = [&](vector<vector<BDD>> &res, int size) {
+        if (size == 0) {
+            return;
+        }
+        res.resize(task->get_num_variables());
+        for (int var = 0; var < task->get_num_variables(); ++var) {
+            load_vector(res[var], task->get_variable_domain_size(var));
+        }
+    };
+    load_vector(notMutexBDDsFw, layout[0]);
+    load_vector(notMutexBDDsBw, layout[1]);
+    load_vector(notDeadEndFw, layout[2]);
+    load_vector(notDeadEndBw, layout[3]);
+    load_by_fluent(notMutexBDDsByFluentFw, layout[4]);
+    load_by_fluent(notMutexBDDsByFluentBw, layout[5]);
+    load_by_fluent(exactlyOneBDDsByFluent, layout[6]);
+    assert(it == bdds.end());
+    return true;
+}
+
+void SymMutexes::save_to_cache() const {
+    const SymCache *cache = sym_vars->get_cache();
+    if (!cache) {
+        return;
+    }
+    vector<int> layout;
+    vector<BDD> bdds;
+    auto save_vector = [&](const vector<BDD> &bdd_vec) {
+        layout.push_back(bdd_vec.size());
+        bdds.insert(bdds.end(), bdd_vec.begin(), bdd_vec.end());
+    };
+    auto save_by_fluent = [&](const vector<vector<BDD>> &bdd_vecs) {
+        layout.push_back(0);
+        for (const vector<BDD> &bdd_vec : bdd_vecs) {
+            layout.back() += bdd_vec.size();
+            bdds.insert(bdds.end(), bdd_vec.begin(), bdd_vec.end());
+        }
+    };
+    save_vector(notMutexBDDsFw);
+    save_vector(notMutexBDDsBw);
+    save_vector(notDeadEndFw);
+    save_vector(notDeadEndBw);
+    save_by_fluent(notMutexBDDsByFluentFw);
+    save_by_fluent(notMutexBDDsByFluentBw);
+    save_by_fluent(exactlyOneBDDsByFluent);
+    cache->save_ints(get_cache_name() + "_order", sym_vars->get_var_order());
+    cache->save_bdds(*sym_vars, get_cache_name(), bdds);
+    cache->save_ints(get_cache_name() + "_layout", layout);
+}
+
+// States with a fact that is unreachable (in the other direction) are dead
+// ends, independently of the mutex type.
+void SymMutexes::init_dead_ends(
+    const vector<FactPair> &unreachable_facts, vector<BDD> &notDeadEnd) const {
+    if (unreachable_facts.empty()) {
+        return;
+    }
+    BDD res = sym_vars->oneBDD();
+    for (const FactPair &fact : unreachable_facts) {
+        res *= !sym_vars->preBDD(fact.var, fact.value);
+    }
+    notDeadEnd.push_back(res);
+}
 
+void SymMutexes::init(
+    const shared_ptr<AbstractTask> task, const vector<MutexGroup> &mutex_groups,
+    bool genMutexBDD, bool genMutexBDDByFluent, bool fw) {
     vector<vector<BDD>> &notMutexBDDsByFluent =
         (fw ? notMutexBDDsByFluentFw : notMutexBDDsByFluentBw);
 
@@ -7,6 +7,7 @@
 #include "../mutex_group.h"
 
 #include <algorithm>
+#include <string>
 
 namespace symbolic {
 struct SymMutexes {
@@ -31,8 +32,16 @@ struct SymMutexes {
 
 protected:
     void init(
-        const std::shared_ptr<AbstractTask> task, bool genMutexBDD,
+        const std::shared_ptr<AbstractTask> task,
+        const std::vector<MutexGroup> &mutex_groups, bool genMutexBDD,
         bool genMutexBDDByFluent, bool fw);
+    void init_dead_ends(
+        const std::vector<FactPair> &unreachable_facts,
+        std::vector<BDD> &notDeadEnd) const;
+
+    std::string get_cache_name() const;
+    bool load_from_cache(const std::shared_ptr<AbstractTask> &task);
+    void save_to_cache() const;
 };
 }
 
@@ -14,15 +14,37 @@ SymParameters::SymParameters(
           opts.get<ConditionalEffectsTransitionType>("ce_transition_type")),
       max_tr_size(opts.get<int>("max_tr_size")),
       max_tr_time(opts.get<int>("max_tr_time")),
+      tr_merge_strategy(
+          opts.get<TransitionMergeStrategy>("tr_merge_strategy")),
+      strips_tr_max_eff_vars(opts.get<int>("strips_tr_max_eff_vars")),
+      partitioned_image(opts.get<bool>("partitioned_image")),
+      image_threads(opts.get<int>("image_threads")),
+      adaptive_tr_clustering(opts.get<int>("adaptive_tr_clustering")),
+      profile_images(opts.get<bool>("profile_images")),
+      max_frontier_splits(opts.get<int>("max_frontier_splits")),
+      closed_compaction(opts.get<int>("closed_compaction")),
+      closed_spill_layers(opts.get<int>("closed_spill_layers")),
+      closed_spill_dir(opts.get<string>("closed_spill_dir")),
+      add_layers(opts.get<bool>("add_layers")),
+      open_merge_nodes(opts.get<int>("open_merge_nodes")),
+      frontier_merge_time(opts.get<int>("frontier_merge_time")),
+      frontier_merge_nodes(opts.get<int>("frontier_merge_nodes")),
+      fused_filter(opts.get<bool>("fused_filter")),
       mutex_type(opts.get<MutexType>("mutex_type")),
+      mutex_care_set(opts.get<bool>("mutex_care_set")),
       max_mutex_size(opts.get<int>("max_mutex_size")),
       max_mutex_time(opts.get<int>("max_mutex_time")),
+      h2_mutexes(opts.get<bool>("h2_mutexes")),
+      max_h2_time(opts.get<int>("max_h2_time")),
       max_aux_nodes(opts.get<int>("max_aux_nodes")),
       max_aux_time(opts.get<int>("max_aux_time")),
       max_alloted_time(opts.get<int>("max_alloted_time")),
       max_alloted_nodes(opts.get<int>("max_alloted_nodes")),
       ratio_alloted_time(opts.get<double>("ratio_alloted_time")),
       ratio_alloted_nodes(opts.get<double>("ratio_alloted_nodes")),
+      direction_selection(
+          opts.get<DirectionSelection>("direction_selection")),
+      direction_blowup_factor(opts.get<double>("direction_blowup_factor")),
       non_stop(opts.get<bool>("non_stop")),
       print_symbolic_task_size(opts.get<bool>("print_symbolic_task_size")) {
     // Don't use edeletion with conditional effects
@@ -56,13 +78,38 @@ void SymParameters::increase_bound() {
 
 void SymParameters::print_options() const {
     utils::g_log << "TR(time=" << max_tr_time << ", nodes=" << max_tr_size
-                 << ", ce_type=" << ce_transition_type << ")" << endl;
+                 << ", ce_type=" << ce_transition_type
+                 << ", merge=" << tr_merge_strategy
+                 << ", strips_eff_vars=" << strips_tr_max_eff_vars << ")"
+                 << endl;
+    utils::g_log << "Image: " << (partitioned_image ? "partitioned" : "single")
+                 << " threads=" << image_threads
+                 << " adaptive_clustering=" << adaptive_tr_clustering
+                 << " profile=" << (profile_images ? "True" : "False")
+                 << " max_frontier_splits=" << max_frontier_splits << endl;
+    if (add_layers) {
+        utils::g_log << "Open and closed list: ADD of g values" << endl;
+    } else if (closed_compaction > 0) {
+        utils::g_log << "Closed list: last " << closed_compaction
+                     << " layers as BDDs, older ones in an ADD" << endl;
+    } else if (closed_spill_layers > 0) {
+        utils::g_log << "Closed list: last " << closed_spill_layers
+                     << " layers in memory, older ones spilled to "
+                     << closed_spill_dir << endl;
+    }
+    utils::g_log << "Merge(open_nodes=" << open_merge_nodes
+                 << ", frontier_time=" << frontier_merge_time
+                 << ", frontier_nodes=" << frontier_merge_nodes << ")" << endl;
+    utils::g_log << "Fused filter: " << (fused_filter ? "True" : "False")
+                 << endl;
     utils::g_log << "Mutex(time=" << max_mutex_time
                  << ", nodes=" << max_mutex_size << ", type=" << mutex_type
+                 << ", care_set=" << (mutex_care_set ? "True" : "False")
+                 << ", h2=" << (h2_mutexes ? "True" : "False")
                  << ")" << endl;
     utils::g_log << "Aux(time=" << max_aux_time << ", nodes=" << max_aux_nodes
                  << ")" << endl;
-    utils::g_log << "Max alloted time (for bd): "
+    utils::g_log << "Max alloted time: "
                  << (max_alloted_time == 0
                          ? "INF"
                          : to_string(max_alloted_time / 1000.0) + "s")
@@ -70,8 +117,10 @@ void SymParameters::print_options() const {
                  << (max_alloted_nodes == 0 ? "INF"
                                             : to_string(max_alloted_nodes))
                  << endl;
-    utils::g_log << "Mult alloted time (for bd): " << ratio_alloted_time
+    utils::g_log << "Mult alloted time: " << ratio_alloted_time
                  << " nodes: " << ratio_alloted_nodes << endl;
+    utils::g_log << "Direction selection (for bd): " << direction_selection
+                 << " blowup_factor=" << direction_blowup_factor << endl;
 }
 
 void SymParameters::add_options_to_feature(plugins::Feature &feature) {
@@ -80,28 +129,152 @@ void SymParameters::add_options_to_feature(plugins::Feature &feature) {
     feature.add_option<int>("max_tr_size", "maximum size of TR BDDs", "100000");
     feature.add_option<int>(
         "max_tr_time", "maximum time (ms) to generate TR BDDs", "60000");
+    feature.add_option<TransitionMergeStrategy>(
+        "tr_merge_strategy", "which transition relations are merged together",
+        "index");
+    feature.add_option<int>(
+        "strips_tr_max_eff_vars",
+        "operators without conditional effects and with at most this number "
+        "of effects are not merged, but applied without primed variables by "
+        "quantifying and then setting their effect variables (0 disables it)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<bool>(
+        "partitioned_image",
+        "compute images with transition relations grouped by their changed "
+        "variables, renaming once per group and disjoining the results in a "
+        "balanced tree",
+        "false");
+    feature.add_option<int>(
+        "image_threads",
+        "number of threads to compute images; with more than one thread, the "
+        "transition relations are distributed among worker threads with "
+        "separate BDD managers (takes precedence over partitioned_image)",
+        "1", plugins::Bounds("1", "infinity"));
+    feature.add_option<int>(
+        "adaptive_tr_clustering",
+        "number of images whose measured time per transition relation is used "
+        "to split expensive and fuse cheap merged transition relations "
+        "afterwards (0 disables the reclustering)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<bool>(
+        "profile_images",
+        "measure the calls, time, input and output nodes and exceptions of the "
+        "images of each transition relation and print them ranked by time at "
+        "the end of the search (disables parallel and partitioned images)",
+        "false");
+    feature.add_option<int>(
+        "max_frontier_splits",
+        "if the image of a frontier BDD exceeds the node limit of the step, "
+        "split the BDD by its topmost variable and compute the images of both "
+        "parts separately, at most this number of times per layer (0 "
+        "truncates the step instead)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<int>(
+        "closed_compaction",
+        "number of most recent closed layers stored as separate BDDs; older "
+        "layers are compacted into one ADD that maps states to their cost (0 "
+        "keeps all layers as BDDs; not used by top-k searches)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<int>(
+        "closed_spill_layers",
+        "number of most recent closed layers kept in memory; older layers are "
+        "written to closed_spill_dir and loaded again for solution cuts and "
+        "plan reconstruction (0 keeps all layers in memory; not used with "
+        "closed_compaction, add_layers or by top-k searches)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<string>(
+        "closed_spill_dir",
+        "directory of the spilled closed layers. Each run writes to a "
+        "subdirectory named after its process id, which is removed at the "
+        "end of the run. If the planner is killed (e.g., on the time or "
+        "memory limit), the subdirectory remains until the next run that "
+        "spills to the same directory removes it, or it can be removed by "
+        "hand or by the calling script",
+        "\"closed_layers\"");
+    feature.add_option<bool>(
+        "add_layers",
+        "represent the g values of the open list by a single ADD and compact "
+        "all but the current closed layer into an ADD, instead of one BDD per "
+        "g value (overrides closed_compaction; not used by top-k searches)",
+        "false");
+    feature.add_option<int>(
+        "open_merge_nodes",
+        "disjoin the BDDs inserted into the open list with the same g value "
+        "in a balanced tree as long as the results have at most this number "
+        "of nodes (0 keeps them separately until they are expanded)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<int>(
+        "frontier_merge_time",
+        "maximum time (ms) to disjoin the BDDs of a bucket before expanding "
+        "it",
+        "60000", plugins::Bounds("0", "infinity"));
+    feature.add_option<int>(
+        "frontier_merge_nodes",
+        "maximum number of nodes of the disjunctions of the BDDs of a bucket "
+        "before expanding it",
+        "10000000", plugins::Bounds("0", "infinity"));
+    feature.add_option<bool>(
+        "fused_filter",
+        "merge a bucket when it is popped from the open list and then remove "
+        "the states closed in both directions and the mutex states in a "
+        "single pass over each BDD; not used by top-k searches",
+        "false");
     feature.add_option<MutexType>(
         "mutex_type", "mutex type", "MUTEX_EDELETION");
+    feature.add_option<bool>(
+        "mutex_care_set",
+        "use the mutexes and dead ends as care set to simplify the closed "
+        "lists with Restrict; they are conjoined exactly only to detect cuts "
+        "and reconstruct plans",
+        "false");
     feature.add_option<int>(
         "max_mutex_size", "maximum size of mutex BDDs", "100000");
     feature.add_option<int>(
         "max_mutex_time", "maximum time (ms) to generate mutex BDDs", "60000");
+    feature.add_option<bool>(
+        "h2_mutexes",
+        "compute h^2 mutexes of the task before generating the mutex BDDs "
+        "(not needed if the task was processed by the h2 preprocessor)",
+        "false");
+    feature.add_option<int>(
+        "max_h2_time",
+        "maximum time (ms) to compute h^2 mutexes; it is part of the search "
+        "time",
+        "60000");
     feature.add_option<int>(
         "max_aux_nodes", "maximum size in pop operations", "1000000");
     feature.add_option<int>(
         "max_aux_time", "maximum time (ms) in pop operations", "2000");
     feature.add_option<int>(
-        "max_alloted_time", "maximum alloted time for an step",
+        "max_alloted_time",
+        "maximum alloted time (ms) for a step of the uni- and bidirectional "
+        "searches",
         to_string(60000));
     feature.add_option<int>(
-        "max_alloted_nodes", "maximum alloted nodes for an step",
+        "max_alloted_nodes",
+        "maximum alloted nodes for a step of the uni- and bidirectional "
+        "searches",
         to_string(10000000));
     feature.add_option<double>(
-        "ratio_alloted_time", "multiplier to decide alloted time for a step",
+        "ratio_alloted_time",
+        "multiplier of the alloted time after a truncated step",
         "2.0");
     feature.add_option<double>(
-        "ratio_alloted_nodes", "multiplier to decide alloted nodes for a step",
+        "ratio_alloted_nodes",
+        "multiplier of the alloted nodes after a truncated step",
         "2.0");
+    feature.add_option<DirectionSelection>(
+        "direction_selection",
+        "how the bidirectional search selects the direction of the next step "
+        "(ignored if alternating)",
+        "estimation");
+    feature.add_option<double>(
+        "direction_blowup_factor",
+        "with direction_selection=prediction, the bidirectional search "
+        "continues only in one direction once the other one is predicted to "
+        "be slower and to produce a larger image, and by this factor in the "
+        "step time or the image nodes (0 disables it)",
+        "0", plugins::Bounds("0", "infinity"));
     feature.add_option<bool>(
         "non_stop",
         "Removes initial state from closed to avoid backward search to stop.",
@@ -6,6 +6,7 @@
 #include "../abstract_task.h"
 
 #include <algorithm>
+#include <string>
 
 namespace plugins {
 class Options;
@@ -16,9 +17,26 @@ namespace symbolic {
 struct SymParameters {
     ConditionalEffectsTransitionType ce_transition_type;
     int max_tr_size, max_tr_time;
+    TransitionMergeStrategy tr_merge_strategy;
+    int strips_tr_max_eff_vars; // Max effects for TRs without primed vars
+    bool partitioned_image; // Grouped TRs with balanced disjunction of images
+    int image_threads; // Number of threads used to compute images
+    int adaptive_tr_clustering; // Images measured before reclustering TRs
+    bool profile_images; // Statistics of the images of each TR
+    int max_frontier_splits; // Splits per layer if an image exceeds the nodes
+    int closed_compaction; // Closed layers kept as BDDs (0 = all)
+    int closed_spill_layers; // Closed layers kept in memory (0 = all)
+    std::string closed_spill_dir; // Directory of the spilled closed layers
+    bool add_layers; // Open and closed g values as one ADD each
+    int open_merge_nodes; // Max nodes of BDDs disjoined in open (0 = none)
+    int frontier_merge_time, frontier_merge_nodes; // Merge before expansion
+    bool fused_filter; // Merge popped buckets and filter them in one pass
 
     MutexType mutex_type;
+    bool mutex_care_set; // Simplify closed BDDs with Restrict wrt. mutexes
     int max_mutex_size, max_mutex_time;
+    bool h2_mutexes; // Compute h^2 mutexes in addition to the task ones
+    int max_h2_time;
 
     int max_aux_nodes,
         max_aux_time; // Time and memory bounds for auxiliary operations
@@ -28,6 +46,11 @@ struct SymParameters {
     double ratio_alloted_time,
         ratio_alloted_nodes; // factor to multiply the estimation
 
+    DirectionSelection direction_selection;
+    // Ratio of predicted step times or image nodes from which the
+    // bidirectional search continues only in the cheaper direction (0 = never)
+    double direction_blowup_factor;
+
     bool non_stop;
 
     bool print_symbolic_task_size;
@@ -29,7 +29,9 @@ SymStateSpaceManager::SymStateSpaceManager(
       initial_state(sym_vars->zeroBDD()),
       goal(sym_vars->zeroBDD()),
       sym_mutexes(sym_vars, sym_params),
-      sym_transition_relations(sym_vars, sym_params) {
+      sym_transition_relations(sym_vars, sym_params),
+      num_measured_images(0),
+      transitions_version(0) {
     // Transform initial state and goal states if axioms are present
     if (task_properties::has_axioms(TaskProxy(*task))) {
         initial_state =
@@ -48,49 +50,192 @@ SymStateSpaceManager::SymStateSpaceManager(
     sym_mutexes.init(task);
     sym_transition_relations.init(task, sym_mutexes);
 
+    if (sym_params.image_threads > 1) {
+        parallel_image = make_shared<ParallelImage>(
+            sym_vars, sym_transition_relations.get_transition_relations(),
+            sym_params.image_threads);
+    }
+
     if (sym_params.print_symbolic_task_size) {
         print_symbolic_task_size();
     }
 }
 
+BDD SymStateSpaceManager::apply_transition(
+    const TransitionRelationPtr &tr, bool fw, const BDD &bdd,
+    int node_limit) const {
+    if (!per_transition_images()) {
+        return fw ? tr->image(bdd, node_limit) : tr->preimage(bdd, node_limit);
+    }
+    TransitionRelationStatistics *profile = nullptr;
+    if (sym_params.profile_images) {
+        auto &entry = image_profile[tr.get()];
+        entry.first = tr;
+        profile = &entry.second;
+        ++profile->num_images;
+        profile->input_nodes += bdd.nodeCount();
+    }
+    utils::Timer timer;
+    BDD res = bdd;
+    try {
+        res = fw ? tr->image(bdd, node_limit) : tr->preimage(bdd, node_limit);
+    } catch (const BDDError &e) {
+        if (profile) {
+            profile->time += timer();
+            ++profile->num_exceptions;
+        }
+        throw;
+    }
+    double time = timer();
+    if (profile) {
+        profile->time += time;
+        profile->output_nodes += res.nodeCount();
+    }
+    if (is_measuring()) {
+        TransitionRelationStatistics &stats = tr_statistics[tr.get()];
+        ++stats.num_images;
+        stats.time += time;
+    }
+    return res;
+}
+
+void SymStateSpaceManager::recluster_transitions() {
+    sym_transition_relations.recluster(tr_statistics);
+    tr_statistics.clear();
+    ++transitions_version;
+    if (parallel_image) {
+        parallel_image = make_shared<ParallelImage>(
+            sym_vars, sym_transition_relations.get_transition_relations(),
+            sym_params.image_threads);
+    }
+}
+
 void SymStateSpaceManager::zero_preimage(
-    BDD bdd, vector<BDD> &res, int node_limit) const {
-    for (const auto &tr :
-         sym_transition_relations.get_transition_relations().at(0)) {
-        res.push_back(tr->preimage(bdd, node_limit));
+    BDD bdd, vector<BDD> &res, int node_limit, ImageProgress &progress) const {
+    if (parallel_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            map<int, Bucket> parallel_res;
+            parallel_image->image(false, true, bdd, parallel_res, node_limit);
+            copy_bucket(parallel_res[0], res);
+            ++progress.num_done;
+        }
+        return;
+    }
+    if (sym_params.partitioned_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            sym_transition_relations.get_image_schedule().image(
+                false, 0, bdd, res, node_limit);
+            ++progress.num_done;
+        }
+        return;
+    }
+    const auto &trs = sym_transition_relations.get_transition_relations().at(0);
+    for (size_t i = progress.num_done; i < trs.size(); ++i) {
+        res.push_back(apply_transition(trs[i], false, bdd, node_limit));
+        ++progress.num_done;
     }
 }
 
 void SymStateSpaceManager::zero_image(
-    BDD bdd, vector<BDD> &res, int node_limit) const {
-    for (const auto &tr :
-         sym_transition_relations.get_transition_relations().at(0)) {
-        res.push_back(tr->image(bdd, node_limit));
+    BDD bdd, vector<BDD> &res, int node_limit, ImageProgress &progress) const {
+    if (parallel_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            map<int, Bucket> parallel_res;
+            parallel_image->image(true, true, bdd, parallel_res, node_limit);
+            copy_bucket(parallel_res[0], res);
+            ++progress.num_done;
+        }
+        return;
+    }
+    if (sym_params.partitioned_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            sym_transition_relations.get_image_schedule().image(
+                true, 0, bdd, res, node_limit);
+            ++progress.num_done;
+        }
+        return;
+    }
+    const auto &trs = sym_transition_relations.get_transition_relations().at(0);
+    for (size_t i = progress.num_done; i < trs.size(); ++i) {
+        res.push_back(apply_transition(trs[i], true, bdd, node_limit));
+        ++progress.num_done;
     }
 }
 
 void SymStateSpaceManager::cost_preimage(
-    BDD bdd, map<int, vector<BDD>> &res, int node_limit) const {
+    BDD bdd, map<int, vector<BDD>> &res, int node_limit,
+    ImageProgress &progress) const {
+    if (parallel_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            map<int, Bucket> parallel_res;
+            parallel_image->image(false, false, bdd, parallel_res, node_limit);
+            for (const auto &[cost, bucket] : parallel_res) {
+                copy_bucket(bucket, res[cost]);
+            }
+            ++progress.num_done;
+        }
+        return;
+    }
+    // Index of the current transition relation (or group) in the image
+    int step = 0;
     for (auto trs : sym_transition_relations.get_transition_relations()) {
         int cost = trs.first;
         if (cost == 0)
             continue;
+        if (sym_params.partitioned_image && !per_transition_images()) {
+            if (step++ >= progress.num_done) {
+                sym_transition_relations.get_image_schedule().image(
+                    false, cost, bdd, res[cost], node_limit);
+                ++progress.num_done;
+            }
+            continue;
+        }
         for (size_t i = 0; i < trs.second.size(); i++) {
-            BDD result = trs.second[i]->preimage(bdd, node_limit);
+            if (step++ < progress.num_done)
+                continue;
+            BDD result =
+                apply_transition(trs.second[i], false, bdd, node_limit);
             res[cost].push_back(result);
+            ++progress.num_done;
         }
     }
 }
 
 void SymStateSpaceManager::cost_image(
-    BDD bdd, map<int, vector<BDD>> &res, int node_limit) const {
+    BDD bdd, map<int, vector<BDD>> &res, int node_limit,
+    ImageProgress &progress) const {
+    if (parallel_image && !per_transition_images()) {
+        if (progress.num_done == 0) {
+            map<int, Bucket> parallel_res;
+            parallel_image->image(true, false, bdd, parallel_res, node_limit);
+            for (const auto &[cost, bucket] : parallel_res) {
+                copy_bucket(bucket, res[cost]);
+            }
+            ++progress.num_done;
+        }
+        return;
+    }
+    // Index of the current transition relation (or group) in the image
+    int step = 0;
     for (auto trs : sym_transition_relations.get_transition_relations()) {
         int cost = trs.first;
         if (cost == 0)
             continue;
+        if (sym_params.partitioned_image && !per_transition_images()) {
+            if (step++ >= progress.num_done) {
+                sym_transition_relations.get_image_schedule().image(
+                    true, cost, bdd, res[cost], node_limit);
+                ++progress.num_done;
+            }
+            continue;
+        }
         for (size_t i = 0; i < trs.second.size(); i++) {
-            BDD result = trs.second[i]->image(bdd, node_limit);
+            if (step++ < progress.num_done)
+                continue;
+            BDD result =
+                apply_transition(trs.second[i], true, bdd, node_limit);
             res[cost].push_back(result);
+            ++progress.num_done;
         }
     }
 }
@@ -151,6 +296,32 @@ void SymStateSpaceManager::filter_mutex(
         sym_params.max_aux_nodes);
 }
 
+vector<BDD> SymStateSpaceManager::get_care_set(bool fw) const {
+    vector<BDD> care_set =
+        fw ? sym_mutexes.notDeadEndFw : sym_mutexes.notDeadEndBw;
+    copy_bucket(
+        fw ? sym_mutexes.notMutexBDDsFw : sym_mutexes.notMutexBDDsBw,
+        care_set);
+    return care_set;
+}
+
+void SymStateSpaceManager::filter_bucket(
+    Bucket &bucket, const vector<BDD> &constraints, bool fw,
+    bool initialization) {
+    // The constraints are exact, so they are applied without the aux limits
+    for (BDD &bdd : bucket) {
+        for (const BDD &constraint : constraints) {
+            bdd *= constraint;
+            if (bdd.IsZero()) {
+                break;
+            }
+        }
+    }
+    remove_zero(bucket);
+    filter_mutex(bucket, fw, initialization);
+    remove_zero(bucket);
+}
+
 void SymStateSpaceManager::merge_bucket(Bucket &bucket) const {
     merge_bucket(bucket, sym_params.max_aux_time, sym_params.max_aux_nodes);
 }
@@ -159,6 +330,62 @@ void SymStateSpaceManager::merge_bucket_and(Bucket &bucket) const {
     merge_bucket_and(bucket, sym_params.max_aux_time, sym_params.max_aux_nodes);
 }
 
+// Operator names of a TR. Merged TRs are labeled with their first operator
+// and the number of operators.
+static string get_transition_label(
+    const TaskProxy &task_proxy, const TransitionRelation &tr) {
+    auto disj_tr = dynamic_cast<const DisjunctiveTransitionRelation *>(&tr);
+    if (disj_tr && disj_tr->get_operator_ids().size() != 1) {
+        const set<OperatorID> &op_ids = disj_tr->get_operator_ids();
+        if (op_ids.empty()) {
+            return "(no operators)";
+        }
+        OperatorProxy op = task_proxy.get_operators()[*op_ids.begin()];
+        return "merged " + to_string(op_ids.size()) + " ops: " +
+               op.get_name() + ", ...";
+    }
+    string kind = "disj";
+    if (dynamic_cast<const ConjunctiveTransitionRelation *>(&tr)) {
+        kind = "conj";
+    } else if (dynamic_cast<const StripsTransitionRelation *>(&tr)) {
+        kind = "strips";
+    }
+    OperatorProxy op = task_proxy.get_operators()[tr.get_unique_operator_id()];
+    return kind + " " + op.get_name();
+}
+
+void SymStateSpaceManager::print_image_profile() const {
+    if (!sym_params.profile_images) {
+        return;
+    }
+    vector<pair<const TransitionRelation *, TransitionRelationStatistics>>
+        ranking;
+    double total_time = 0;
+    for (const auto &entry : image_profile) {
+        ranking.emplace_back(entry.first, entry.second.second);
+        total_time += entry.second.second.time;
+    }
+    sort(ranking.begin(), ranking.end(), [](const auto &a, const auto &b) {
+        return a.second.time > b.second.time;
+    });
+
+    TaskProxy task_proxy(*task);
+    utils::g_log << "Image profile (" << ranking.size()
+                 << " transition relations, " << total_time << "s):" << endl;
+    for (size_t i = 0; i < ranking.size(); ++i) {
+        const TransitionRelationStatistics &stats = ranking[i].second;
+        utils::g_log << "  " << i + 1 << ". "
+                     << get_transition_label(task_proxy, *ranking[i].first)
+                     << ": images=" << stats.num_images
+                     << " time=" << stats.time << "s ("
+                     << static_cast<int>(
+                            total_time > 0 ? 100 * stats.time / total_time : 0)
+                     << "%) input_nodes=" << stats.input_nodes
+                     << " output_nodes=" << stats.output_nodes
+                     << " exceptions=" << stats.num_exceptions << endl;
+    }
+}
+
 void SymStateSpaceManager::print_symbolic_task_size() const {
     utils::g_log << endl;
     utils::g_log << "Initial state size: " << initial_state.nodeCount() << endl;
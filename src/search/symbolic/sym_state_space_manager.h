@@ -1,6 +1,7 @@
 #ifndef SYMBOLIC_SYM_STATE_SPACE_MANAGER_H
 #define SYMBOLIC_SYM_STATE_SPACE_MANAGER_H
 
+#include "parallel_image.h"
 #include "sym_bucket.h"
 #include "sym_enums.h"
 #include "sym_mutexes.h"
@@ -25,6 +26,18 @@ class SdacTask;
 namespace symbolic {
 class SymVariables;
 
+/*
+ * Progress of an image that was truncated by the time or node limit. The
+ * images of the transition relations (or groups of them, with a partitioned
+ * or parallel image) that were completed remain in the result, so that the
+ * image can be resumed with the next one. The progress is only valid for the
+ * version of the transition relations it was created with.
+ */
+struct ImageProgress {
+    int num_done = 0;
+    int version = 0;
+};
+
 class SymStateSpaceManager {
 protected:
     SymVariables *sym_vars;
@@ -36,15 +49,62 @@ protected:
 
     SymMutexes sym_mutexes;
     SymTransitionRelations sym_transition_relations;
+    std::shared_ptr<ParallelImage> parallel_image; // Only if image_threads > 1
+
+    // Image times per transition relation, measured during the first
+    // adaptive_tr_clustering images to recluster the transition relations
+    mutable TransitionRelationStatisticsMap tr_statistics;
+    int num_measured_images;
+    // Increased whenever the transition relations change
+    int transitions_version;
+
+    // Statistics of all images if profile_images is enabled. The TRs are
+    // kept alive so that their addresses are not reused after reclustering.
+    mutable std::map<
+        const TransitionRelation *,
+        std::pair<TransitionRelationPtr, TransitionRelationStatistics>>
+        image_profile;
+
+    bool is_measuring() const {
+        return num_measured_images < sym_params.adaptive_tr_clustering;
+    }
+    // The images are computed one TR at a time (not parallel or partitioned)
+    bool per_transition_images() const {
+        return is_measuring() || sym_params.profile_images;
+    }
+    BDD apply_transition(
+        const TransitionRelationPtr &tr, bool fw, const BDD &bdd,
+        int max_nodes) const;
+    void recluster_transitions();
+
+    // Validates the progress of a truncated image, restarting it (and
+    // discarding its partial result) if the transition relations changed.
+    template<typename Result>
+    void check_progress(ImageProgress &progress, Result &res) const {
+        if (progress.version != transitions_version) {
+            if (progress.num_done > 0) {
+                res.clear();
+            }
+            progress.num_done = 0;
+            progress.version = transitions_version;
+        }
+    }
 
     // All the methods may throw exceptions in case the time or nodes are
-    // exceeded.
-    void zero_preimage(BDD bdd, std::vector<BDD> &res, int max_nodes) const;
+    // exceeded. They skip the first progress.num_done transition relations
+    // (or groups) and count the ones completed.
+    void zero_preimage(
+        BDD bdd, std::vector<BDD> &res, int max_nodes,
+        ImageProgress &progress) const;
     void cost_preimage(
-        BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes) const;
-    void zero_image(BDD bdd, std::vector<BDD> &res, int maxn_nodes) const;
+        BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes,
+        ImageProgress &progress) const;
+    void zero_image(
+        BDD bdd, std::vector<BDD> &res, int max_nodes,
+        ImageProgress &progress) const;
     void cost_image(
-        BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes) const;
+        BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes,
+        ImageProgress &progress) const;
 
 public:
     SymStateSpaceManager(
@@ -54,8 +114,26 @@ public:
     virtual ~SymStateSpaceManager() {
     }
 
+    // Ranks the TRs by the total time of their images (profile_images)
+    void print_image_profile() const;
+
     void filter_mutex(Bucket &bucket, bool fw, bool initialization);
+    // Invariants of the states that are relevant for the given direction
+    // (not dead ends and not mutex)
+    std::vector<BDD> get_care_set(bool fw) const;
+    // Conjoins each BDD of the bucket with all constraints (exactly), skipping
+    // the remaining ones as soon as it becomes empty, and then filters the
+    // mutexes of the non-empty BDDs within the aux limits.
+    void filter_bucket(
+        Bucket &bucket, const std::vector<BDD> &constraints, bool fw,
+        bool initialization);
     void merge_bucket(Bucket &bucket) const;
+    // Merges a bucket of the frontier before its expansion
+    void merge_frontier_bucket(Bucket &bucket) const {
+        merge_bucket(
+            bucket, sym_params.frontier_merge_time,
+            sym_params.frontier_merge_nodes);
+    }
     void merge_bucket_and(Bucket &bucket) const;
 
     BDD get_goal() {
@@ -65,12 +143,19 @@ public:
         return initial_state;
     }
 
+    SymVariables *get_sym_vars() const {
+        return sym_vars;
+    }
+
     BDD zeroBDD() const {
         return sym_vars->zeroBDD();
     }
     BDD oneBDD() const {
         return sym_vars->oneBDD();
     }
+    ADD constant(double c) const {
+        return sym_vars->constant(c);
+    }
 
     bool merge_bucket(Bucket &bucket, int maxTime, int maxNodes) const {
         auto mergeBDDs = [](BDD bdd, BDD bdd2, int maxNodes) {
@@ -100,20 +185,29 @@ public:
         return sym_transition_relations.get_min_transition_cost();
     }
 
-    void zero_image(bool fw, BDD bdd, std::vector<BDD> &res, int max_nodes) {
+    void zero_image(
+        bool fw, BDD bdd, std::vector<BDD> &res, int max_nodes,
+        ImageProgress &progress) {
+        check_progress(progress, res);
         if (fw) {
-            zero_image(bdd, res, max_nodes);
+            zero_image(bdd, res, max_nodes, progress);
         } else {
-            zero_preimage(bdd, res, max_nodes);
+            zero_preimage(bdd, res, max_nodes, progress);
         }
     }
 
     void cost_image(
-        bool fw, BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes) {
+        bool fw, BDD bdd, std::map<int, std::vector<BDD>> &res, int max_nodes,
+        ImageProgress &progress) {
+        check_progress(progress, res);
         if (fw) {
-            cost_image(bdd, res, max_nodes);
+            cost_image(bdd, res, max_nodes, progress);
         } else {
-            cost_preimage(bdd, res, max_nodes);
+            cost_preimage(bdd, res, max_nodes, progress);
+        }
+        if (is_measuring() &&
+            ++num_measured_images == sym_params.adaptive_tr_clustering) {
+            recluster_transitions();
         }
     }
 
@@ -131,6 +225,30 @@ public:
         sym_vars->unset_time_limit();
     }
 
+    void reorder_if_grown() {
+        sym_vars->reorder_if_grown();
+    }
+
+    int get_max_frontier_splits() const {
+        return sym_params.max_frontier_splits;
+    }
+
+    bool node_limit_exceeded() const {
+        return sym_vars->node_limit_exceeded();
+    }
+
+    // Splits bdd into the disjoint parts where its topmost variable is true
+    // and false, respectively. Returns false if bdd is constant.
+    bool split_by_top_variable(const BDD &bdd, BDD &pos, BDD &neg) const {
+        if (bdd.IsZero() || bdd.IsOne()) {
+            return false;
+        }
+        BDD var = sym_vars->bddVar(bdd.NodeReadIndex());
+        pos = bdd * var;
+        neg = bdd * !var;
+        return true;
+    }
+
     // For plan solution reconstruction
     std::shared_ptr<SymTransitionRelations> get_transition_relations() const {
         return std::make_shared<SymTransitionRelations>(
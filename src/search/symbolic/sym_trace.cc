@@ -0,0 +1,69 @@
+#include "sym_trace.h"
+
+#include "../utils/system.h"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace symbolic {
+SymTrace::SymTrace(const string &file_name) : file(file_name) {
+    if (!file) {
+        cerr << "Could not open trace file " << file_name << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+void SymTrace::set_json(const string &key, const string &value) {
+    for (auto &field : fields) {
+        if (field.first == key) {
+            field.second = value;
+            return;
+        }
+    }
+    fields.emplace_back(key, value);
+}
+
+void SymTrace::set(const string &key, long value) {
+    set_json(key, to_string(value));
+}
+
+void SymTrace::set(const string &key, double value) {
+    ostringstream json;
+    json << value;
+    set_json(key, json.str());
+}
+
+// The values are short identifiers (e.g., the direction), so they are not
+// escaped.
+void SymTrace::set(const string &key, const string &value) {
+    set_json(key, "\"" + value + "\"");
+}
+
+void SymTrace::add_time(const string &phase, double seconds) {
+    for (auto &time : times) {
+        if (time.first == phase) {
+            time.second += seconds;
+            return;
+        }
+    }
+    times.emplace_back(phase, seconds);
+}
+
+void SymTrace::write_layer() {
+    file << "{";
+    for (size_t i = 0; i < fields.size(); ++i) {
+        file << (i ? ", " : "") << "\"" << fields[i].first
+             << "\": " << fields[i].second;
+    }
+    file << (fields.empty() ? "" : ", ") << "\"time\": {";
+    for (size_t i = 0; i < times.size(); ++i) {
+        file << (i ? ", " : "") << "\"" << times[i].first
+             << "\": " << times[i].second;
+    }
+    file << "}}" << endl;
+    fields.clear();
+    times.clear();
+}
+}
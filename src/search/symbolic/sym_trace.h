@@ -0,0 +1,39 @@
+#ifndef SYMBOLIC_SYM_TRACE_H
+#define SYMBOLIC_SYM_TRACE_H
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace symbolic {
+/*
+ * Telemetry of the symbolic search: writes one JSON object per line with the
+ * statistics of each search step (layer). During the step, the searches set
+ * fields (e.g., the node counts of the frontier) and accumulate the time of
+ * each phase. The engine adds the manager statistics and writes the line at
+ * the end of the step.
+ */
+class SymTrace {
+    std::ofstream file;
+    // Fields of the current layer, with their values already in JSON
+    std::vector<std::pair<std::string, std::string>> fields;
+    std::vector<std::pair<std::string, double>> times;
+
+    void set_json(const std::string &key, const std::string &value);
+
+public:
+    explicit SymTrace(const std::string &file_name);
+
+    void set(const std::string &key, long value);
+    void set(const std::string &key, double value);
+    void set(const std::string &key, const std::string &value);
+
+    // Adds seconds to the time of a phase in the current layer
+    void add_time(const std::string &phase, double seconds);
+
+    void write_layer();
+};
+}
+
+#endif
@@ -1,16 +1,132 @@
 #include "sym_transition_relations.h"
 
+#include "sym_cache.h"
 #include "sym_utils.h"
 
 #include "../task_utils/task_properties.h"
 #include "../tasks/effect_aggregated_task.h"
 #include "../utils/logging.h"
+#include "../utils/timer.h"
 
+#include <algorithm>
+#include <iterator>
+#include <map>
 #include <numeric>
+#include <sstream>
+#include <unordered_set>
 
 using namespace std;
 
 namespace symbolic {
+// Merged TRs whose image time differs from the median by this factor are
+// split (if more expensive) or fused with each other (if cheaper).
+static const double RECLUSTER_FACTOR = 4.0;
+
+// Size of the intersection divided by the size of the union of two sorted
+// vectors
+template<class T>
+static double jaccard(const vector<T> &v1, const vector<T> &v2) {
+    if (v1.empty() && v2.empty()) {
+        return 1;
+    }
+    size_t common = 0;
+    auto it1 = v1.begin();
+    auto it2 = v2.begin();
+    while (it1 != v1.end() && it2 != v2.end()) {
+        if (*it1 < *it2) {
+            ++it1;
+        } else if (*it2 < *it1) {
+            ++it2;
+        } else {
+            ++common;
+            ++it1;
+            ++it2;
+        }
+    }
+    return static_cast<double>(common) / (v1.size() + v2.size() - common);
+}
+
+/*
+ * Reorders the TRs such that merging neighbours (as mergeAux does) merges
+ * similar TRs first. TRs with the same effect variables form a cluster, so
+ * they are merged without quantifying or renaming additional variables.
+ * Clusters are chained greedily, always continuing with the cluster that
+ * shares most effect variables (and then variables in the BDD support) with
+ * the last one. If the time runs out, the remaining clusters are appended in
+ * lexicographic order of their effect variables.
+ */
+static void order_by_affinity(
+    vector<DisjunctiveTransitionRelation> &trs, int max_time) {
+    struct Cluster {
+        vector<int> eff_vars;
+        vector<unsigned int> support;
+        vector<size_t> trs;
+    };
+
+    utils::Timer timer;
+    map<vector<int>, Cluster> clusters_by_eff;
+    for (size_t i = 0; i < trs.size(); ++i) {
+        const unordered_set<int> &eff_vars = trs[i].get_eff_vars();
+        vector<int> key(eff_vars.begin(), eff_vars.end());
+        sort(key.begin(), key.end());
+        Cluster &cluster = clusters_by_eff[key];
+        cluster.eff_vars = key;
+        vector<unsigned int> support = trs[i].get_tr_BDD().SupportIndices();
+        vector<unsigned int> merged_support;
+        sort(support.begin(), support.end());
+        set_union(
+            cluster.support.begin(), cluster.support.end(), support.begin(),
+            support.end(), back_inserter(merged_support));
+        cluster.support.swap(merged_support);
+        cluster.trs.push_back(i);
+    }
+    vector<Cluster> clusters;
+    clusters.reserve(clusters_by_eff.size());
+    for (auto &entry : clusters_by_eff) {
+        clusters.push_back(move(entry.second));
+    }
+
+    vector<size_t> order;
+    vector<bool> chained(clusters.size(), false);
+    size_t last = 0;
+    for (size_t step = 0; step < clusters.size(); ++step) {
+        size_t next = clusters.size();
+        if (step == 0) {
+            next = 0;
+        } else if (max_time <= 0 || timer() * 1000 < max_time) {
+            double best_affinity = -1;
+            for (size_t i = 0; i < clusters.size(); ++i) {
+                if (chained[i]) {
+                    continue;
+                }
+                // Shared effect variables are weighted higher because they
+                // determine the variables to quantify and rename.
+                double affinity =
+                    2 * jaccard(clusters[last].eff_vars, clusters[i].eff_vars) +
+                    jaccard(clusters[last].support, clusters[i].support);
+                if (affinity > best_affinity) {
+                    best_affinity = affinity;
+                    next = i;
+                }
+            }
+        } else {
+            next = find(chained.begin(), chained.end(), false) -
+                   chained.begin();
+        }
+        chained[next] = true;
+        order.insert(
+            order.end(), clusters[next].trs.begin(), clusters[next].trs.end());
+        last = next;
+    }
+
+    vector<DisjunctiveTransitionRelation> ordered_trs;
+    ordered_trs.reserve(trs.size());
+    for (size_t i : order) {
+        ordered_trs.push_back(move(trs[i]));
+    }
+    trs.swap(ordered_trs);
+}
+
 SymTransitionRelations::SymTransitionRelations(
     SymVariables *sym_vars, const SymParameters &sym_params)
     : sym_vars(sym_vars), sym_params(sym_params) {
@@ -18,19 +134,34 @@ SymTransitionRelations::SymTransitionRelations(
 
 void SymTransitionRelations::init(
     const shared_ptr<AbstractTask> &task, const SymMutexes &sym_mutexes) {
-    init_individual_transitions(task, sym_mutexes);
-
-    utils::g_log << "Individual transition relations: "
-                 << get_size(individual_disj_transitions) +
-                        get_size(individual_conj_transitions)
-                 << endl;
-    utils::g_log << "Individual disjunctive transition relations: "
-                 << get_size(individual_disj_transitions) << endl;
-    utils::g_log << "Individual conjunctive transition relations: "
-                 << get_size(individual_conj_transitions) << endl;
-
-    utils::g_log << "Merging transition relations..." << endl;
-    create_merged_transitions();
+    create_strips_trs(task, sym_mutexes);
+
+    string cache_name = get_cache_name(task);
+    if (!cache_name.empty() && load_from_cache(task, cache_name)) {
+        utils::g_log << "Transition relations loaded from cache." << endl;
+    } else {
+        init_individual_transitions(task, sym_mutexes);
+
+        utils::g_log << "Individual transition relations: "
+                     << get_size(individual_disj_transitions) +
+                            get_size(individual_conj_transitions)
+                     << endl;
+        utils::g_log << "Individual disjunctive transition relations: "
+                     << get_size(individual_disj_transitions) << endl;
+        utils::g_log << "Individual conjunctive transition relations: "
+                     << get_size(individual_conj_transitions) << endl;
+
+        // TRs with auxiliary variables cannot be restored from the cache
+        bool cacheable = individual_conj_transitions.empty() &&
+                         sym_vars->get_num_aux_variables() == 0;
+
+        utils::g_log << "Merging transition relations..." << endl;
+        create_merged_transitions();
+
+        if (!cache_name.empty() && cacheable) {
+            save_to_cache(cache_name);
+        }
+    }
 
     // Fill individual_transitions with individual_disj_transitions
     for (const auto &[cost, tr_vec] : individual_disj_transitions) {
@@ -40,6 +171,39 @@ void SymTransitionRelations::init(
         }
     }
 
+    // Fill individual_transitions with individual_conj_transitions
+    for (const auto &[cost, tr_vec] : individual_conj_transitions) {
+        for (const auto &tr : tr_vec) {
+            individual_transitions[cost].emplace_back(
+                make_shared<ConjunctiveTransitionRelation>(tr));
+        }
+    }
+
+    fill_transitions();
+
+    min_transition_cost = individual_transitions.empty()
+                              ? numeric_limits<int>::max()
+                              : individual_transitions.begin()->first;
+    utils::g_log << "Merged transition relations: " << get_size(transitions)
+                 << endl;
+    utils::g_log << "Merged disjunctive transition relations: "
+                 << get_size(disj_transitions) << endl;
+    utils::g_log << "Merged conjunctive transition relations: "
+                 << get_size(individual_conj_transitions) << endl;
+    if (!strips_op_ids.empty()) {
+        utils::g_log << "STRIPS transition relations without primed "
+                     << "variables: " << strips_op_ids.size() << endl;
+    }
+
+    if (sym_params.partitioned_image) {
+        utils::g_log << "Image schedule groups: "
+                     << image_schedule.num_groups() << endl;
+    }
+}
+
+void SymTransitionRelations::fill_transitions() {
+    transitions.clear();
+
     // Fill transitions with disj_transitions
     for (const auto &[cost, tr_vec] : disj_transitions) {
         for (const auto &tr : tr_vec) {
@@ -48,27 +212,123 @@ void SymTransitionRelations::init(
         }
     }
 
+    // Fill transitions with strips_transitions
+    for (const auto &[cost, tr_vec] : strips_transitions) {
+        transitions[cost].insert(
+            transitions[cost].end(), tr_vec.begin(), tr_vec.end());
+    }
+
     // Fill transitions with individual_conj_transitions
     for (const auto &[cost, tr_vec] : individual_conj_transitions) {
         for (const auto &tr : tr_vec) {
-            individual_transitions[cost].emplace_back(
-                make_shared<ConjunctiveTransitionRelation>(tr));
             transitions[cost].emplace_back(
                 make_shared<ConjunctiveTransitionRelation>(tr));
         }
     }
 
-    min_transition_cost = individual_transitions.empty()
-                              ? numeric_limits<int>::max()
-                              : individual_transitions.begin()->first;
-    utils::g_log << "Merged transition relations: " << get_size(transitions)
-                 << endl;
-    utils::g_log << "Merged disjunctive transition relations: "
-                 << get_size(transitions) -
-                        get_size(individual_conj_transitions)
-                 << endl;
-    utils::g_log << "Merged conjunctive transition relations: "
-                 << get_size(individual_conj_transitions) << endl;
+    if (sym_params.partitioned_image) {
+        image_schedule.init(transitions);
+    }
+}
+
+void SymTransitionRelations::recluster(
+    const TransitionRelationStatisticsMap &statistics) {
+    utils::Timer timer;
+    int num_before = get_size(disj_transitions);
+    int num_split = 0;
+    for (auto &[cost, tr_vec] : disj_transitions) {
+        // Merged TRs are the first entries of transitions[cost]
+        const vector<TransitionRelationPtr> &tr_ptrs = transitions.at(cost);
+        vector<double> image_times(tr_vec.size(), -1);
+        vector<double> measured_times;
+        for (size_t i = 0; i < tr_vec.size(); ++i) {
+            auto it = statistics.find(tr_ptrs[i].get());
+            if (it != statistics.end() && it->second.num_images > 0) {
+                image_times[i] = it->second.time / it->second.num_images;
+                measured_times.push_back(image_times[i]);
+            }
+        }
+        if (measured_times.size() < 2) {
+            continue;
+        }
+        auto median_it = measured_times.begin() + measured_times.size() / 2;
+        nth_element(measured_times.begin(), median_it, measured_times.end());
+        double median_time = *median_it;
+
+        vector<DisjunctiveTransitionRelation> new_tr_vec;
+        vector<DisjunctiveTransitionRelation> cheap_trs;
+        for (size_t i = 0; i < tr_vec.size(); ++i) {
+            if (image_times[i] > RECLUSTER_FACTOR * median_time &&
+                split_transition(cost, tr_vec[i], new_tr_vec)) {
+                ++num_split;
+            } else if (
+                image_times[i] >= 0 &&
+                image_times[i] * RECLUSTER_FACTOR < median_time) {
+                cheap_trs.push_back(tr_vec[i]);
+            } else {
+                new_tr_vec.push_back(tr_vec[i]);
+            }
+        }
+
+        // Cheap TRs are fused with twice the usual size bound
+        merge(
+            sym_vars, cheap_trs, disjunctive_tr_merge, sym_params.max_tr_time,
+            2 * sym_params.max_tr_size);
+        new_tr_vec.insert(new_tr_vec.end(), cheap_trs.begin(), cheap_trs.end());
+        tr_vec.swap(new_tr_vec);
+    }
+
+    fill_transitions();
+    utils::g_log << "Reclustered transition relations: " << num_before
+                 << " => " << get_size(disj_transitions) << " (" << num_split
+                 << " split) [t=" << timer << "]" << endl;
+}
+
+bool SymTransitionRelations::split_transition(
+    int cost, const DisjunctiveTransitionRelation &tr,
+    vector<DisjunctiveTransitionRelation> &res) const {
+    const set<OperatorID> &op_ids = tr.get_operator_ids();
+    if (op_ids.size() <= 1) {
+        return false;
+    }
+
+    // Collect the individual TRs the merged TR consists of
+    vector<DisjunctiveTransitionRelation> parts;
+    size_t num_ops = 0;
+    for (const auto &individual_tr : individual_disj_transitions.at(cost)) {
+        const set<OperatorID> &individual_ops =
+            individual_tr.get_operator_ids();
+        if (individual_ops.empty()) {
+            // We can not identify to which merged TR this TR belongs
+            return false;
+        }
+        if (includes(
+                op_ids.begin(), op_ids.end(), individual_ops.begin(),
+                individual_ops.end())) {
+            parts.push_back(individual_tr);
+            num_ops += individual_ops.size();
+        }
+    }
+    if (num_ops != op_ids.size()) {
+        return false;
+    }
+
+    // Merge each half of the parts into TRs of at most half the size
+    int max_nodes = max(1, tr.nodeCount() / 2);
+    size_t half = parts.size() / 2;
+    vector<DisjunctiveTransitionRelation> first(
+        parts.begin(), parts.begin() + half);
+    vector<DisjunctiveTransitionRelation> second(
+        parts.begin() + half, parts.end());
+    merge(
+        sym_vars, first, disjunctive_tr_merge, sym_params.max_tr_time,
+        max_nodes);
+    merge(
+        sym_vars, second, disjunctive_tr_merge, sym_params.max_tr_time,
+        max_nodes);
+    res.insert(res.end(), first.begin(), first.end());
+    res.insert(res.end(), second.begin(), second.end());
+    return true;
 }
 
 void SymTransitionRelations::init_individual_transitions(
@@ -83,6 +343,17 @@ void SymTransitionRelations::init_individual_transitions(
                  << sym_vars->get_num_aux_variables() << endl;
 }
 
+bool SymTransitionRelations::is_strips_operator(
+    const TaskProxy &task_proxy, OperatorID op_id) const {
+    if (sym_params.strips_tr_max_eff_vars == 0 ||
+        task_properties::has_conditional_effects(task_proxy, op_id)) {
+        return false;
+    }
+    EffectsProxy effects = task_proxy.get_operators()[op_id].get_effects();
+    return static_cast<int>(effects.size()) <=
+           sym_params.strips_tr_max_eff_vars;
+}
+
 void SymTransitionRelations::create_single_trs(
     const shared_ptr<AbstractTask> &task, const SymMutexes &sym_mutexes) {
     // For Conjunctive Transiton Relations in presence of CEs
@@ -120,10 +391,148 @@ void SymTransitionRelations::create_single_trs(
     }
 }
 
+void SymTransitionRelations::create_strips_trs(
+    const shared_ptr<AbstractTask> &task, const SymMutexes &sym_mutexes) {
+    TaskProxy task_proxy(*task);
+    for (int i = 0; i < task->get_num_operators(); ++i) {
+        // The disjunctive TR is still used for plan reconstruction
+        if (!is_strips_operator(task_proxy, OperatorID(i))) {
+            continue;
+        }
+        auto strips_tr = make_shared<StripsTransitionRelation>(
+            sym_vars, OperatorID(i), task);
+        if (sym_params.mutex_type == MutexType::MUTEX_EDELETION) {
+            strips_tr->edeletion(
+                sym_mutexes.notMutexBDDsByFluentFw,
+                sym_mutexes.notMutexBDDsByFluentBw,
+                sym_mutexes.exactlyOneBDDsByFluent);
+        }
+        strips_transitions[strips_tr->get_cost()].push_back(strips_tr);
+        strips_op_ids.insert(OperatorID(i));
+    }
+}
+
+string SymTransitionRelations::get_cache_name(
+    const shared_ptr<AbstractTask> &task) const {
+    if (!sym_vars->get_cache()) {
+        return "";
+    }
+    // The TRs also depend on the operator costs, which may differ from the
+    // task used for the cache directory (e.g., with cost transformations),
+    // and on the variable order, which determines the BDD variables.
+    ostringstream params;
+    params << sym_params.ce_transition_type << " " << sym_params.mutex_type
+           << " " << sym_params.max_mutex_size << " "
+           << sym_params.max_mutex_time << " " << sym_params.h2_mutexes << " "
+           << sym_params.max_h2_time << " " << sym_params.max_tr_size << " "
+           << sym_params.max_tr_time << " " << sym_params.tr_merge_strategy
+           << " " << sym_params.strips_tr_max_eff_vars << "\n";
+    for (int i = 0; i < task->get_num_operators(); ++i) {
+        params << task->get_operator_cost(i, false) << " ";
+    }
+    params << "\n";
+    for (int var : sym_vars->get_var_order()) {
+        params << var << " ";
+    }
+    return "transitions_" + SymCache::compute_hash(params.str());
+}
+
+/*
+ * The cache entry stores for each individual and merged disjunctive TR its
+ * kind, cost, operators and effect variables, followed by all TR BDDs in the
+ * same order. The remaining members are derived from the effect variables.
+ */
+bool SymTransitionRelations::load_from_cache(
+    const shared_ptr<AbstractTask> &task, const string &cache_name) {
+    const SymCache *cache = sym_vars->get_cache();
+    vector<int> layout;
+    vector<int> var_order;
+    vector<BDD> bdds;
+    if (!cache->load_ints(cache_name + "_order", var_order) ||
+        var_order != sym_vars->get_var_order() ||
+        !cache->load_ints(cache_name + "_layout", layout) ||
+        !cache->load_bdds(*sym_vars, cache_name, bdds)) {
+        return false;
+    }
+
+    map<int, vector<DisjunctiveTransitionRelation>> loaded_individual;
+    map<int, vector<DisjunctiveTransitionRelation>> loaded_merged;
+    size_t pos = 0;
+    auto next = [&layout, &pos]() {
+        return pos < layout.size() ? layout[pos++] : -1;
+    };
+    for (const BDD &bdd : bdds) {
+        int kind = next();
+        int cost = next();
+        int num_ops = next();
+        if (kind < 0 || cost < 0 || num_ops < 0) {
+            return false;
+        }
+        DisjunctiveTransitionRelation tr(sym_vars, task);
+        tr.set_cost(cost);
+        tr.set_tr_BDD(bdd);
+        set<OperatorID> op_ids;
+        for (int i = 0; i < num_ops; ++i) {
+            int op = next();
+            if (op < 0 || op >= task->get_num_operators()) {
+                return false;
+            }
+            op_ids.insert(OperatorID(op));
+        }
+        tr.setOpsIds(op_ids);
+        int num_eff_vars = next();
+        for (int i = 0; i < num_eff_vars; ++i) {
+            int var = next();
+            if (var < 0 || var >= task->get_num_variables()) {
+                return false;
+            }
+            tr.add_eff_var(var);
+            tr.add_exist_var(var);
+            tr.add_swap_var(var);
+        }
+        (kind == 0 ? loaded_individual : loaded_merged)[cost].push_back(tr);
+    }
+    if (pos != layout.size()) {
+        return false;
+    }
+    individual_disj_transitions.swap(loaded_individual);
+    disj_transitions.swap(loaded_merged);
+    return true;
+}
+
+void SymTransitionRelations::save_to_cache(const string &cache_name) const {
+    vector<int> layout;
+    vector<BDD> bdds;
+    for (int kind : {0, 1}) {
+        const auto &trs =
+            kind == 0 ? individual_disj_transitions : disj_transitions;
+        for (const auto &[cost, tr_vec] : trs) {
+            for (const DisjunctiveTransitionRelation &tr : tr_vec) {
+                layout.push_back(kind);
+                layout.push_back(cost);
+                layout.push_back(tr.get_operator_ids().size());
+                for (const OperatorID &op_id : tr.get_operator_ids()) {
+                    layout.push_back(op_id.get_index());
+                }
+                vector<int> eff_vars(
+                    tr.get_eff_vars().begin(), tr.get_eff_vars().end());
+                sort(eff_vars.begin(), eff_vars.end());
+                layout.push_back(eff_vars.size());
+                layout.insert(layout.end(), eff_vars.begin(), eff_vars.end());
+                bdds.push_back(tr.get_tr_BDD());
+            }
+        }
+    }
+    const SymCache *cache = sym_vars->get_cache();
+    cache->save_ints(cache_name + "_order", sym_vars->get_var_order());
+    cache->save_bdds(*sym_vars, cache_name, bdds);
+    cache->save_ints(cache_name + "_layout", layout);
+}
+
 void SymTransitionRelations::create_merged_transitions() {
     if (sym_params.max_tr_time <= 0 || sym_params.max_tr_size <= 0) {
         move_monolithic_conj_transitions();
-        disj_transitions = individual_disj_transitions; // Copy
+        copy_mergeable_transitions();
         return;
     }
     utils::g_log << "Conjunctive merging..." << endl;
@@ -141,17 +550,34 @@ void SymTransitionRelations::create_merged_transitions() {
     // individual_disj_transitions By that we can further merge them
     move_monolithic_conj_transitions();
 
-    disj_transitions = individual_disj_transitions; // Copy
+    copy_mergeable_transitions();
 
     utils::g_log << "Disjunctive merging..." << endl;
     for (auto it = disj_transitions.begin(); it != disj_transitions.end();
          ++it) {
+        if (sym_params.tr_merge_strategy ==
+            TransitionMergeStrategy::AFFINITY) {
+            order_by_affinity(it->second, sym_params.max_tr_time);
+        }
         merge(
             sym_vars, it->second, disjunctive_tr_merge, sym_params.max_tr_time,
             sym_params.max_tr_size);
     }
 }
 
+void SymTransitionRelations::copy_mergeable_transitions() {
+    disj_transitions.clear();
+    for (const auto &[cost, tr_vec] : individual_disj_transitions) {
+        for (const auto &tr : tr_vec) {
+            const set<OperatorID> &op_ids = tr.get_operator_ids();
+            if (op_ids.size() == 1 && strips_op_ids.count(*op_ids.begin())) {
+                continue;
+            }
+            disj_transitions[cost].push_back(tr);
+        }
+    }
+}
+
 void SymTransitionRelations::move_monolithic_conj_transitions() {
     // Temporary map to hold new individual_disj_transitions
     map<int, vector<ConjunctiveTransitionRelation>>
@@ -1,21 +1,35 @@
 #ifndef SYMBOLIC_SYM_TRANSITION_RELATIONS_H
 #define SYMBOLIC_SYM_TRANSITION_RELATIONS_H
 
+#include "image_schedule.h"
 #include "sym_mutexes.h"
 #include "sym_parameters.h"
 #include "sym_variables.h"
 
 #include "transition_relations/conjunctive_transition_relation.h"
 #include "transition_relations/disjunctive_transition_relation.h"
+#include "transition_relations/strips_transition_relation.h"
 #include "transition_relations/transition_relation.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 namespace extra_tasks {
 class SdacTask;
 }
 
 namespace symbolic {
+// Measured cost of the images computed with a transition relation
+struct TransitionRelationStatistics {
+    int num_images = 0;
+    double time = 0; // in seconds
+    long input_nodes = 0, output_nodes = 0; // Sum over the images
+    int num_exceptions = 0; // Images truncated by the time or node limit
+};
+
+using TransitionRelationStatisticsMap = std::unordered_map<
+    const TransitionRelation *, TransitionRelationStatistics>;
+
 class SymTransitionRelations {
     SymVariables *sym_vars;
     const SymParameters &sym_params;
@@ -26,19 +40,46 @@ class SymTransitionRelations {
         individual_disj_transitions;
     std::map<int, std::vector<TransitionRelationPtr>> individual_transitions;
 
+    // Small STRIPS operators applied without primed variables (not merged)
+    std::map<int, std::vector<std::shared_ptr<StripsTransitionRelation>>>
+        strips_transitions;
+    std::set<OperatorID> strips_op_ids;
+
     std::map<int, std::vector<DisjunctiveTransitionRelation>>
         disj_transitions; // Merged TRs
     std::map<int, std::vector<TransitionRelationPtr>> transitions; // Merged TRs
+    ImageSchedule image_schedule; // Only used with partitioned_image
     int min_transition_cost; // minimum cost of non-zero cost transitions
 
     void init_individual_transitions(
         const std::shared_ptr<AbstractTask> &task,
         const SymMutexes &sym_mutexes);
+    // Operators with few effects and without conditional effects
+    bool is_strips_operator(
+        const TaskProxy &task_proxy, OperatorID op_id) const;
     void create_single_trs(
         const std::shared_ptr<AbstractTask> &task,
         const SymMutexes &sym_mutexes);
+    void create_strips_trs(
+        const std::shared_ptr<AbstractTask> &task,
+        const SymMutexes &sym_mutexes);
     void create_merged_transitions();
+    void copy_mergeable_transitions();
     void move_monolithic_conj_transitions();
+    void fill_transitions();
+
+    // Persistent cache of the disjunctive TRs (see SymCache)
+    std::string get_cache_name(const std::shared_ptr<AbstractTask> &task) const;
+    bool load_from_cache(
+        const std::shared_ptr<AbstractTask> &task,
+        const std::string &cache_name);
+    void save_to_cache(const std::string &cache_name) const;
+
+    // Replaces a merged TR by smaller merged TRs of its individual TRs.
+    // Returns false if the TR cannot be split.
+    bool split_transition(
+        int cost, const DisjunctiveTransitionRelation &tr,
+        std::vector<DisjunctiveTransitionRelation> &res) const;
 
     template<class T>
     int get_size(std::map<int, std::vector<T>> transitions) const;
@@ -50,6 +91,10 @@ public:
         const std::shared_ptr<AbstractTask> &task,
         const SymMutexes &sym_mutexes);
 
+    // Splits merged TRs whose images are expensive and fuses cheap ones,
+    // based on the image times measured during the search.
+    void recluster(const TransitionRelationStatisticsMap &statistics);
+
     int get_min_transition_cost() const;
     bool has_zero_cost_transition() const;
     bool has_unit_cost() const;
@@ -58,6 +103,10 @@ public:
     get_transition_relations() const;
     const std::map<int, std::vector<TransitionRelationPtr>> &
     get_individual_transition_relations() const;
+
+    const ImageSchedule &get_image_schedule() const {
+        return image_schedule;
+    }
 };
 }
 
@@ -1,5 +1,9 @@
 #include "sym_utils.h"
 
+#include <algorithm>
+
+using namespace std;
+
 namespace symbolic {
 DisjunctiveTransitionRelation disjunctive_tr_merge(
     DisjunctiveTransitionRelation tr, const DisjunctiveTransitionRelation &tr2,
@@ -21,4 +25,80 @@ BDD merge_and_BDD(const BDD &bdd, const BDD &bdd2, int maxSize) {
 BDD merge_or_BDD(const BDD &bdd, const BDD &bdd2, int maxSize) {
     return bdd.Or(bdd2, maxSize);
 }
+
+BalancedOr::BalancedOr(int max_nodes, bool disjoin)
+    : max_nodes(max_nodes), disjoin(disjoin) {
+}
+
+BDD BalancedOr::merge(const BDD &bdd, const BDD &bdd2) {
+    try {
+        return bdd.Or(bdd2, max_nodes);
+    } catch (const BDDError &e) {
+        if (!SymVariables::node_limit_exceeded(bdd.manager())) {
+            throw;
+        }
+        // Keep the larger BDD apart and continue with the smaller one
+        if (bdd.nodeCount() < bdd2.nodeCount()) {
+            unmerged.push_back(bdd2);
+            return bdd;
+        }
+        unmerged.push_back(bdd);
+        return bdd2;
+    }
+}
+
+void BalancedOr::insert(const BDD &bdd) {
+    if (bdd.IsZero()) {
+        return;
+    }
+    if (!disjoin) {
+        unmerged.push_back(bdd);
+        return;
+    }
+    BDD carry = bdd;
+    for (Bucket &level : levels) {
+        if (level.empty()) {
+            level.push_back(carry);
+            return;
+        }
+        carry = merge(level[0], carry);
+        level.clear();
+    }
+    levels.push_back(Bucket{carry});
+}
+
+void BalancedOr::extract(Bucket &res) {
+    bool has_result = false;
+    BDD result;
+    for (Bucket &level : levels) {
+        if (level.empty()) {
+            continue;
+        }
+        result = has_result ? merge(level[0], result) : level[0];
+        has_result = true;
+    }
+    vector<Bucket>().swap(levels);
+
+    res.insert(res.end(), unmerged.begin(), unmerged.end());
+    Bucket().swap(unmerged);
+    if (has_result) {
+        res.push_back(result);
+    }
+}
+
+bool BalancedOr::contains_any_state(const BDD &bdd) const {
+    for (const Bucket &level : levels) {
+        if (bucket_contains_any_state(level, bdd)) {
+            return true;
+        }
+    }
+    return bucket_contains_any_state(unmerged, bdd);
+}
+
+bool BalancedOr::empty() const {
+    return unmerged.empty() &&
+           all_of(levels.begin(), levels.end(), [](const Bucket &level) {
+               return level.empty();
+           });
+}
 }
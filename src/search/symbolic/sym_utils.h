@@ -94,6 +94,31 @@ void merge(std::vector<T> &elems, FunctionMerge f, int maxSize) {
     mergeAux(elems, f, 0, maxSize);
 }
 
+/*
+ * Disjoins a sequence of BDDs in a balanced binary tree while they are
+ * inserted: level i holds the disjunction of 2^i inserted BDDs (or nothing),
+ * so that only a logarithmic number of partial results is alive. If a
+ * disjunction exceeds max_nodes, its operands are kept separately.
+ * If disjoin is false, the BDDs are only collected.
+ */
+class BalancedOr {
+    int max_nodes;
+    bool disjoin;
+    std::vector<Bucket> levels; // Each level holds at most one BDD
+    Bucket unmerged; // BDDs that could not be merged within max_nodes
+
+    BDD merge(const BDD &bdd, const BDD &bdd2);
+
+public:
+    explicit BalancedOr(int max_nodes = 0, bool disjoin = true);
+
+    void insert(const BDD &bdd);
+    // Disjoins all remaining BDDs, appends the result to res and resets.
+    void extract(Bucket &res);
+    bool empty() const;
+    bool contains_any_state(const BDD &bdd) const;
+};
+
 DisjunctiveTransitionRelation disjunctive_tr_merge(
     DisjunctiveTransitionRelation tr, const DisjunctiveTransitionRelation &tr2,
     int maxSize);
@@ -1,10 +1,12 @@
 #include "sym_variables.h"
 
 #include "opt_order.h"
+#include "ordering_portfolio.h"
 
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 #include "sym_axiom/sym_axiom_compilation.h"
 
 #include <fstream>
@@ -15,27 +17,101 @@
 using namespace std;
 
 namespace symbolic {
+// Approximate sizes (bytes) of a CUDD node and a computed table entry
+static const long CUDD_NODE_BYTES = 32;
+static const long CUDD_CACHE_ENTRY_BYTES = 32;
+
 void exceptionError(string /*message*/) {
     // utils::g_log << message << endl;
     throw BDDError();
 }
 
+// Used if CUDD has a memory cap: exceeding it terminates the search instead
+// of being treated as a truncated operation.
+static void memoryError(string message) {
+    if (message == "Out of memory." || message == "Maximum memory exceeded.") {
+        utils::g_log << "CUDD: " << message << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    exceptionError(message);
+}
+
 SymVariables::SymVariables(
     const plugins::Options &opts, const shared_ptr<AbstractTask> &task)
     : task_proxy(*task),
       task(task),
-      cudd_init_nodes(16000000L),
-      cudd_init_cache_size(16000000L),
-      cudd_init_available_memory(0L),
+      cudd_init_nodes(opts.get<int>("cudd_init_nodes")),
+      cudd_init_cache_size(opts.get<int>("cudd_init_cache_size")),
+      cudd_init_available_memory(
+          static_cast<long>(opts.get<int>("cudd_max_memory")) * 1024 * 1024),
+      cudd_auto_sizing(opts.get<bool>("cudd_auto_sizing")),
       gamer_ordering(opts.get<bool>("gamer_ordering")),
+      gamer_ordering_threads(opts.get<int>("gamer_ordering_threads")),
+      ordering_portfolio(opts.get<bool>("ordering_portfolio")),
+      ordering_probe_layers(opts.get<int>("ordering_probe_layers")),
+      ordering_probe_time(opts.get<int>("ordering_probe_time")),
       dynamic_reordering(opts.get<bool>("dynamic_reordering")),
+      reorder_growth(opts.get<double>("reorder_growth")),
+      reorder_method(opts.get<ReorderingMethod>("reorder_method")),
+      reorder_max_time(opts.get<int>("reorder_max_time")),
+      reorder_max_ratio(opts.get<double>("reorder_max_ratio")),
+      nodes_after_reordering(0),
+      reordering_time(0),
       ax_comp(make_shared<SymAxiomCompilation>(this, task)) {
+    if (cudd_auto_sizing) {
+        set_cudd_sizes_from_memory_limit();
+    }
+    string cache_dir = opts.get<string>("cache_dir");
+    if (!cache_dir.empty()) {
+        cache = make_shared<SymCache>(cache_dir, *task);
+    }
+}
+
+void SymVariables::set_cudd_sizes_from_memory_limit() {
+    int memory_limit = utils::get_memory_limit_in_mb();
+    if (memory_limit <= 0) {
+        utils::g_log << "No memory limit found: CUDD auto sizing disabled."
+                     << endl;
+        return;
+    }
+    // Keep a quarter of the memory for the task, the plan reconstruction and
+    // the memory used by the process outside of CUDD.
+    long memory_bytes = static_cast<long>(memory_limit) * 1024 * 1024;
+    long cudd_memory = memory_bytes / 4 * 3;
+
+    // The unique table grows on demand, so we only preallocate slots for a
+    // small fraction of the nodes that fit into memory. The computed table
+    // is limited by CUDD to a fraction of the maximum memory anyway.
+    cudd_init_nodes = min(
+        max(cudd_memory / CUDD_NODE_BYTES / 16, 1L << 18), 1L << 26);
+    cudd_init_cache_size = min(
+        max(cudd_memory / CUDD_CACHE_ENTRY_BYTES / 8, 1L << 18), 1L << 26);
+    cudd_init_available_memory = cudd_memory;
 }
 
 void SymVariables::init() {
     vector<int> var_order;
-    if (gamer_ordering) {
-        InfluenceGraph::compute_gamer_ordering(var_order, task);
+    if (ordering_portfolio || gamer_ordering) {
+        string cache_name = ordering_portfolio ? "variable_order_portfolio"
+                                               : "variable_order_gamer";
+        if (cache && cache->load_ints(cache_name, var_order) &&
+            var_order.size() == task_proxy.get_variables().size()) {
+            utils::g_log << "Sym variable order loaded from cache." << endl;
+        } else {
+            var_order.clear();
+            if (ordering_portfolio) {
+                var_order = OrderingPortfolio(
+                                task, ordering_probe_layers,
+                                ordering_probe_time, gamer_ordering_threads)
+                                .compute_ordering();
+            } else {
+                InfluenceGraph::compute_gamer_ordering(
+                    var_order, task, gamer_ordering_threads);
+            }
+            if (cache) {
+                cache->save_ints(cache_name, var_order);
+            }
+        }
     } else {
         for (size_t i = 0; i < task_proxy.get_variables().size(); ++i) {
             var_order.push_back(i);
@@ -88,7 +164,12 @@ void SymVariables::init(const vector<int> &v_order) {
         _numBDDVars, 0, cudd_init_nodes / _numBDDVars, cudd_init_cache_size,
         cudd_init_available_memory);
 
-    manager->setHandler(exceptionError);
+    if (cudd_init_available_memory > 0) {
+        manager->SetMaxMemory(cudd_init_available_memory);
+        manager->setHandler(memoryError);
+    } else {
+        manager->setHandler(exceptionError);
+    }
     manager->setTimeoutHandler(exceptionError);
     manager->setNodesExceededHandler(exceptionError);
     aux_cube = oneBDD();
@@ -151,7 +232,9 @@ void SymVariables::init(const vector<int> &v_order) {
         }
     }
 
-    if (dynamic_reordering) {
+    if (dynamic_reordering || reorder_growth > 0) {
+        // Keep the (interleaved) pre and eff variables of each FD variable
+        // together, so that reordering never separates them
         // http://web.mit.edu/sage/export/tmp/y/usr/share/doc/polybori/cudd/node3.html#SECTION000313000000000000000
         size_t var_id = 0;
         for (int var : var_order) {
@@ -160,9 +243,12 @@ void SymVariables::init(const vector<int> &v_order) {
             manager->MakeTreeNode(var_id, var_len * 2, MTR_FIXED);
             var_id += var_len * 2;
         }
-        manager->AutodynEnable(Cudd_ReorderingType::CUDD_REORDER_GROUP_SIFT);
         // Mtr_PrintGroups(manager->ReadTree(), 0);
     }
+    if (dynamic_reordering) {
+        manager->AutodynEnable(Cudd_ReorderingType::CUDD_REORDER_GROUP_SIFT);
+    }
+    search_timer.reset();
 }
 
 double SymVariables::numStates(const BDD &bdd) const {
@@ -329,15 +415,87 @@ BDD SymVariables::getCube(
     return res;
 }
 
+unsigned long SymVariables::get_remaining_time() const {
+    if (!manager->TimeLimited()) {
+        return 0;
+    }
+    unsigned long elapsed = manager->ReadElapsedTime();
+    unsigned long limit = manager->ReadTimeLimit();
+    return elapsed < limit ? limit - elapsed : 1;
+}
+
+bool SymVariables::node_limit_exceeded() const {
+    return node_limit_exceeded(manager->getManager());
+}
+
+bool SymVariables::node_limit_exceeded(DdManager *dd) {
+    bool exceeded = Cudd_ReadErrorCode(dd) == CUDD_TOO_MANY_NODES;
+    Cudd_ClearErrorCode(dd);
+    return exceeded;
+}
+
+shared_ptr<Cudd> SymVariables::create_worker_manager(int num_managers) const {
+    int num_vars = manager->ReadSize();
+    auto worker_manager = make_shared<Cudd>(
+        num_vars, 0, max(1L, cudd_init_nodes / num_managers / num_vars),
+        max(1L, cudd_init_cache_size / num_managers),
+        cudd_init_available_memory / num_managers);
+    worker_manager->setHandler(exceptionError);
+    worker_manager->setTimeoutHandler(exceptionError);
+    worker_manager->setNodesExceededHandler(exceptionError);
+    return worker_manager;
+}
+
 void SymVariables::reoder(int max_time) {
+    Cudd_ReorderingType heuristic = CUDD_REORDER_GROUP_SIFT;
+    switch (reorder_method) {
+    case ReorderingMethod::SIFT:
+        heuristic = CUDD_REORDER_SIFT;
+        break;
+    case ReorderingMethod::GROUP_SIFT:
+        heuristic = CUDD_REORDER_GROUP_SIFT;
+        break;
+    case ReorderingMethod::SYMM_SIFT:
+        heuristic = CUDD_REORDER_SYMM_SIFT;
+        break;
+    }
     set_time_limit(max_time);
     try {
-        Cudd_ReduceHeap(manager->getManager(), CUDD_REORDER_GROUP_SIFT, 0);
+        Cudd_ReduceHeap(manager->getManager(), heuristic, 0);
     } catch (const BDDError &e) {
     }
+    // An interrupted reordering leaves a valid order, but its error code
+    // would make the next operation fail.
+    Cudd_ClearErrorCode(manager->getManager());
     unset_time_limit();
 }
 
+void SymVariables::reorder_if_grown() {
+    if (reorder_growth <= 0) {
+        return;
+    }
+    long nodes = forest_node_count();
+    if (nodes_after_reordering == 0) {
+        nodes_after_reordering = nodes;
+        return;
+    }
+    if (nodes < reorder_growth * nodes_after_reordering) {
+        return;
+    }
+    double budget = reorder_max_ratio * search_timer() - reordering_time;
+    if (budget <= 0) {
+        return;
+    }
+
+    utils::Timer timer;
+    reoder(min(reorder_max_time, static_cast<int>(budget * 1000) + 1));
+    reordering_time += timer();
+    nodes_after_reordering = forest_node_count();
+    utils::g_log << "Reordering (" << reorder_method << "): " << nodes
+                 << " => " << nodes_after_reordering << " nodes [t=" << timer
+                 << ", total=" << reordering_time << "s]" << endl;
+}
+
 void SymVariables::to_dot(const BDD &bdd, const string &file_name) const {
     to_dot(bdd.Add(), file_name);
 }
@@ -364,17 +522,90 @@ void SymVariables::to_dot(const ADD &add, const string &file_name) const {
 void SymVariables::print_options() const {
     utils::g_log << "CUDD Init: nodes=" << cudd_init_nodes
                  << " cache=" << cudd_init_cache_size
-                 << " max_memory=" << cudd_init_available_memory << endl;
-    utils::g_log << "Variable Ordering: " << (gamer_ordering ? "gamer" : "fd")
+                 << " max_memory=" << cudd_init_available_memory
+                 << (cudd_auto_sizing ? " (auto)" : "") << endl;
+    utils::g_log << "Variable Ordering: "
+                 << (ordering_portfolio ? "portfolio"
+                     : gamer_ordering   ? "gamer"
+                                        : "fd")
                  << endl;
     utils::g_log << "Dynamic reordering: "
                  << (dynamic_reordering ? "True" : "False") << endl;
+    if (reorder_growth > 0) {
+        utils::g_log << "Reordering between layers: " << reorder_method
+                     << " growth=" << reorder_growth
+                     << " max_time=" << reorder_max_time
+                     << " max_ratio=" << reorder_max_ratio << endl;
+    }
+    if (cache) {
+        utils::g_log << "Cache directory: " << cache->get_directory() << endl;
+    }
 }
 
 void SymVariables::add_options_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "cudd_init_nodes",
+        "initial number of slots in the CUDD unique table (summed over all "
+        "variables)",
+        "16000000", plugins::Bounds("1", "infinity"));
+    feature.add_option<int>(
+        "cudd_init_cache_size", "initial number of CUDD computed table entries",
+        "16000000", plugins::Bounds("1", "infinity"));
+    feature.add_option<int>(
+        "cudd_max_memory",
+        "maximum memory (MB) used by CUDD; the search stops with an "
+        "out-of-memory exit code if it is exceeded (0 = no limit)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<bool>(
+        "cudd_auto_sizing",
+        "derive the CUDD table sizes and maximum memory from the memory limit "
+        "of the planner (overrides cudd_init_nodes, cudd_init_cache_size and "
+        "cudd_max_memory if a limit is set)",
+        "false");
     feature.add_option<bool>(
         "gamer_ordering", "Use Gamer ordering optimization", "true");
+    feature.add_option<int>(
+        "gamer_ordering_threads",
+        "number of threads among which the random restarts of the Gamer "
+        "ordering optimization are distributed",
+        "1", plugins::Bounds("1", "infinity"));
+    feature.add_option<bool>(
+        "ordering_portfolio",
+        "probe several static variable orderings (Gamer, reverse Gamer, "
+        "FORCE and the orders of variable_order_finder) and use the one with "
+        "the fewest TR and BFS layer nodes (overrides gamer_ordering)",
+        "false");
+    feature.add_option<int>(
+        "ordering_probe_layers",
+        "number of BFS layers computed to probe each ordering", "5",
+        plugins::Bounds("0", "infinity"));
+    feature.add_option<int>(
+        "ordering_probe_time",
+        "maximum time (ms) to probe all orderings of the portfolio", "30000",
+        plugins::Bounds("1", "infinity"));
     feature.add_option<bool>(
         "dynamic_reordering", "Enable dynamic group sift reordering.", "false");
+    feature.add_option<double>(
+        "reorder_growth",
+        "reorder the variables between layers whenever the number of BDD "
+        "nodes has grown by this factor since the last reordering (0 "
+        "disables it)",
+        "0", plugins::Bounds("0", "infinity"));
+    feature.add_option<ReorderingMethod>(
+        "reorder_method", "reordering algorithm used between layers",
+        "group_sift");
+    feature.add_option<int>(
+        "reorder_max_time", "maximum time (ms) of each reordering", "10000",
+        plugins::Bounds("1", "infinity"));
+    feature.add_option<double>(
+        "reorder_max_ratio",
+        "maximum fraction of the search time spent reordering", "0.1",
+        plugins::Bounds("0", "1"));
+    feature.add_option<string>(
+        "cache_dir",
+        "directory to cache the variable order, transition relations and "
+        "mutex BDDs of a task on disk, so that later runs on the same task "
+        "load them instead of recomputing them (empty = no cache)",
+        "\"\"");
 }
 }
@@ -2,6 +2,8 @@
 #define SYMBOLIC_SYM_VARIABLES_H
 
 #include "sym_bucket.h"
+#include "sym_cache.h"
+#include "sym_enums.h"
 
 #include "../tasks/root_task.h"
 #include "../utils/timer.h"
@@ -43,14 +45,31 @@ class SymVariables {
     // Var order used by the algorithm.
     // const VariableOrderType variable_ordering;
     // Parameters to initialize the CUDD manager
-    const long cudd_init_nodes; // Number of initial nodes
-    const long cudd_init_cache_size; // Initial cache size
-    const long cudd_init_available_memory; // Maximum available memory (bytes)
+    long cudd_init_nodes; // Number of initial nodes
+    long cudd_init_cache_size; // Initial cache size
+    long cudd_init_available_memory; // Maximum available memory (bytes)
+    const bool cudd_auto_sizing; // Derive the parameters from the memory limit
     const bool gamer_ordering;
+    const int gamer_ordering_threads;
+    const bool ordering_portfolio;
+    const int ordering_probe_layers;
+    const int ordering_probe_time; // ms
     const bool dynamic_reordering;
 
+    // Reordering between layers when the number of nodes has grown by
+    // reorder_growth since the last reordering, limited to reorder_max_time
+    // (ms) per reordering and a fraction reorder_max_ratio of the search time
+    const double reorder_growth;
+    const ReorderingMethod reorder_method;
+    const int reorder_max_time;
+    const double reorder_max_ratio;
+    long nodes_after_reordering;
+    double reordering_time; // Total time spent reordering (seconds)
+    utils::Timer search_timer;
+
     Cudd *manager; // manager associated with this symbolic search
     std::shared_ptr<SymAxiomCompilation> ax_comp; // used for axioms
+    std::shared_ptr<SymCache> cache; // Only if a cache directory is given
 
     int numBDDVars; // Number of binary variables (just one set, the total
                     // number is numBDDVars*2
@@ -80,6 +99,9 @@ class SymVariables {
 
     void init(const std::vector<int> &v_order);
 
+    // Sets the CUDD parameters relative to the memory limit of the process.
+    void set_cudd_sizes_from_memory_limit();
+
 public:
     SymVariables(
         const plugins::Options &opts,
@@ -91,6 +113,20 @@ public:
         return ax_comp;
     }
 
+    // Returns nullptr if no cache is used
+    const SymCache *get_cache() const {
+        return cache.get();
+    }
+
+    Cudd *get_manager() const {
+        return manager;
+    }
+
+    // The BDD variables of each FD variable depend on this order
+    const std::vector<int> &get_var_order() const {
+        return var_order;
+    }
+
     double numStates(const BDD &bdd) const;
 
     std::vector<BDD> get_variables() {
@@ -218,12 +254,46 @@ public:
         manager->UnsetTimeLimit();
     }
 
+    // Remaining time (ms) of the current time limit or 0 if there is none.
+    unsigned long get_remaining_time() const;
+
+    // Whether the last failed operation exceeded its node limit (and not,
+    // e.g., the time limit). Clears the error code of the manager.
+    bool node_limit_exceeded() const;
+    // Same for any manager, e.g., a worker manager.
+    static bool node_limit_exceeded(DdManager *dd);
+
+    // Creates a separate manager with the same BDD variables, e.g., to work
+    // in another thread. The CUDD tables are split among num_managers.
+    std::shared_ptr<Cudd> create_worker_manager(int num_managers) const;
+
+    // Copies a BDD of another manager into this manager.
+    inline BDD transfer(const BDD &bdd) const {
+        return bdd.Transfer(*manager);
+    }
+
     long forest_node_count() const {
         return manager->ReadNodeCount();
     }
 
+    // Statistics of the manager since its creation
+    double cache_hit_rate() const {
+        double lookups = manager->ReadCacheLookUps();
+        return lookups > 0 ? manager->ReadCacheHits() / lookups : 0;
+    }
+    long garbage_collections() const {
+        return manager->ReadGarbageCollections();
+    }
+    double get_reordering_time() const {
+        return reordering_time;
+    }
+
     void reoder(int max_time);
 
+    // Reorders the variables if the number of nodes has grown enough since
+    // the last reordering and the reordering budget is not exhausted.
+    void reorder_if_grown();
+
     void to_dot(const BDD &bdd, const std::string &file_name) const;
     void to_dot(const ADD &bdd, const std::string &file_name) const;
 
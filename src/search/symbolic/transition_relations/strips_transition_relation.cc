@@ -0,0 +1,92 @@
+#include "strips_transition_relation.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace symbolic {
+StripsTransitionRelation::StripsTransitionRelation(
+    SymVariables *sym_vars, OperatorID op_id,
+    const shared_ptr<AbstractTask> &task)
+    : TransitionRelation(),
+      sym_vars(sym_vars),
+      task_proxy(*task),
+      op_id(op_id),
+      cost(task_proxy.get_operators()[op_id].get_cost()),
+      pre(sym_vars->oneBDD()),
+      post(sym_vars->oneBDD()),
+      eff_cube(sym_vars->oneBDD()) {
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    for (FactProxy cond : op.get_preconditions()) {
+        FactPair fact = cond.get_pair();
+        pre *= sym_vars->get_axiom_compiliation()->get_primary_representation(
+            fact.var, fact.value);
+    }
+    for (EffectProxy eff : op.get_effects()) {
+        assert(eff.get_conditions().empty());
+        FactPair fact = eff.get_fact().get_pair();
+        post *= sym_vars->preBDD(fact.var, fact.value);
+        eff_cube *= sym_vars->getCubePre(fact.var);
+    }
+}
+
+// Same mutexes as DisjunctiveTransitionRelation::edeletion, but the ones on
+// the resulting state are not renamed to primed variables.
+void StripsTransitionRelation::edeletion(
+    const vector<vector<BDD>> &notMutexBDDsByFluentFw,
+    const vector<vector<BDD>> &notMutexBDDsByFluentBw,
+    const vector<vector<BDD>> &exactlyOneBDDsByFluent) {
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    for (EffectProxy eff : op.get_effects()) {
+        FactPair pp = eff.get_fact().get_pair();
+        FactPair pre_fact(-1, -1);
+        for (FactProxy cond : op.get_preconditions()) {
+            if (cond.get_pair().var == pp.var) {
+                pre_fact = cond.get_pair();
+                break;
+            }
+        }
+
+        // edeletion bw
+        if (pre_fact.var == -1) {
+            for (int val = 0;
+                 val < task_proxy.get_variables()[pp.var].get_domain_size();
+                 val++) {
+                pre *= notMutexBDDsByFluentBw[pp.var][val];
+            }
+        } else {
+            pre *= notMutexBDDsByFluentBw[pp.var][pre_fact.value];
+        }
+        // edeletion fw
+        post *= notMutexBDDsByFluentFw[pp.var][pp.value];
+
+        // edeletion invariants
+        pre *= exactlyOneBDDsByFluent[pp.var][pp.value];
+    }
+}
+
+BDD StripsTransitionRelation::image(const BDD &from, int max_nodes) const {
+    BDD res = from.AndAbstract(pre, eff_cube, max_nodes);
+    return res.And(post, max_nodes);
+}
+
+BDD StripsTransitionRelation::preimage(const BDD &from, int max_nodes) const {
+    BDD res = from.AndAbstract(post, eff_cube, max_nodes);
+    return res.And(pre, max_nodes);
+}
+
+BDD StripsTransitionRelation::preimage(
+    const BDD &from, const BDD &constraint_to, int max_nodes) const {
+    BDD res = from.And(constraint_to, max_nodes);
+    res = res.AndAbstract(post, eff_cube, max_nodes);
+    return res.And(pre, max_nodes);
+}
+
+int StripsTransitionRelation::nodeCount() const {
+    return pre.nodeCount() + post.nodeCount();
+}
+
+const OperatorID &StripsTransitionRelation::get_unique_operator_id() const {
+    return op_id;
+}
+}
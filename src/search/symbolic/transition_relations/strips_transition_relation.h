@@ -0,0 +1,53 @@
+#ifndef SYMBOLIC_TRANSITION_RELATIONS_STRIPS_TRANSITION_RELATION_H
+#define SYMBOLIC_TRANSITION_RELATIONS_STRIPS_TRANSITION_RELATION_H
+
+#include "transition_relation.h"
+
+#include "../sym_variables.h"
+
+#include "../../task_proxy.h"
+
+#include <vector>
+
+namespace symbolic {
+/*
+ * Represents the transition relation of a single operator without
+ * conditional effects, which is applied without a relational product and
+ * without primed variables: the image conjoins the states with the
+ * precondition, forgets the values of the effect variables and conjoins the
+ * result with the effect literals.
+ */
+class StripsTransitionRelation : public TransitionRelation {
+    SymVariables *sym_vars; // To call basic BDD creation methods
+    TaskProxy task_proxy; // Use task_proxy to access task information.
+    OperatorID op_id;
+    int cost; // transition cost
+
+    BDD pre; // Condition on the states before applying the operator
+    BDD post; // Condition on the states after applying the operator
+    BDD eff_cube; // Cube with the (unprimed) effect variables
+
+public:
+    StripsTransitionRelation(
+        SymVariables *sym_vars, OperatorID op_id,
+        const std::shared_ptr<AbstractTask> &task);
+
+    void edeletion(
+        const std::vector<std::vector<BDD>> &notMutexBDDsByFluentFw,
+        const std::vector<std::vector<BDD>> &notMutexBDDsByFluentBw,
+        const std::vector<std::vector<BDD>> &exactlyOneBDDsByFluent);
+
+    BDD image(const BDD &from, int max_nodes = 0U) const override;
+    BDD preimage(const BDD &from, int max_nodes = 0U) const override;
+    BDD preimage(const BDD &from, const BDD &constraint_to, int max_nodes = 0U)
+        const override;
+
+    virtual int nodeCount() const override;
+    const OperatorID &get_unique_operator_id() const override;
+
+    int get_cost() const {
+        return cost;
+    }
+};
+}
+#endif
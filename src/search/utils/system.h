@@ -65,12 +65,20 @@ NO_RETURN extern void exit_with(ExitCode returncode);
 NO_RETURN extern void exit_with_reentrant(ExitCode returncode);
 
 int get_peak_memory_in_kb();
+/*
+  Returns the address space limit of the process (as set by the driver) in MB
+  or -1 if no limit is set or it cannot be determined.
+*/
+int get_memory_limit_in_mb();
 const char *get_exit_code_message_reentrant(ExitCode exitcode);
 bool is_exit_code_error_reentrant(ExitCode exitcode);
 void register_event_handlers();
 void report_exit_code(ExitCode exitcode);
 void report_exit_code_reentrant(ExitCode exitcode);
 int get_process_id();
+// Whether a process with the given id is running (e.g., to clean up the
+// files of killed runs)
+bool is_process_running(int pid);
 }
 
 #endif
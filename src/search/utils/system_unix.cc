@@ -33,6 +33,7 @@
 #include <limits>
 #include <new>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #if OPERATING_SYSTEM == OSX
@@ -222,6 +223,13 @@ int get_peak_memory_in_kb() {
     return memory_in_kb;
 }
 
+int get_memory_limit_in_mb() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_AS, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+        return -1;
+    return static_cast<int>(limit.rlim_cur / (1024 * 1024));
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
@@ -270,6 +278,11 @@ void report_exit_code_reentrant(ExitCode exitcode) {
 int get_process_id() {
     return getpid();
 }
+
+bool is_process_running(int pid) {
+    // EPERM: the process exists, but belongs to another user
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
 }
 
 #endif
@@ -36,6 +36,11 @@ int get_peak_memory_in_kb() {
     return pmc.PeakPagefileUsage / 1024;
 }
 
+int get_memory_limit_in_mb() {
+    // The driver does not impose memory limits on Windows.
+    return -1;
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
@@ -64,6 +69,19 @@ void report_exit_code_reentrant(ExitCode exitcode) {
 int get_process_id() {
     return _getpid();
 }
+
+bool is_process_running(int pid) {
+    HANDLE process =
+        OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!process) {
+        return false;
+    }
+    DWORD exit_code;
+    bool running = GetExitCodeProcess(process, &exit_code) &&
+                   exit_code == STILL_ACTIVE;
+    CloseHandle(process);
+    return running;
+}
 }
 
 #endif